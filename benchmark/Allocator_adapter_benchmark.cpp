@@ -0,0 +1,41 @@
+#include "allocator/buddy_allocator.hpp"
+#include "allocator/pool_allocator.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <map>
+
+// std::map inserts and erases: every one allocates or frees a node
+TEST_CASE("AllocatorAdapter - Map Churn (Routed vs Buddy vs std::allocator)",
+          "[allocator_adapter][routing][speed]") {
+    const int NUM_KEYS = 5000;
+    using value = std::pair<const int, int>;
+
+    auto churn = [&](auto& map) {
+        for (int i = 0; i < NUM_KEYS; ++i) {
+            map.emplace((i * 7919) % NUM_KEYS, i);
+        }
+        for (int i = 0; i < NUM_KEYS; ++i) {
+            map.erase(i);
+        }
+    };
+
+    BENCHMARK_ADVANCED("Map-Routed-Pool-Nodes")(Catch::Benchmark::Chronometer meter) {
+        allocator::buddy_allocator buddy(16 * 1024 * 1024);
+        allocator::pool_allocator nodes(64, NUM_KEYS);
+        std::map<int, int, std::less<>, allocator::AllocatorAdapter<value>> map{
+            allocator::AllocatorAdapter<value>(&buddy, &nodes)};
+        meter.measure([&] { churn(map); });
+    };
+
+    BENCHMARK_ADVANCED("Map-Buddy-Only")(Catch::Benchmark::Chronometer meter) {
+        allocator::buddy_allocator buddy(16 * 1024 * 1024);
+        std::map<int, int, std::less<>, allocator::AllocatorAdapter<value>> map{
+            allocator::AllocatorAdapter<value>(&buddy)};
+        meter.measure([&] { churn(map); });
+    };
+
+    BENCHMARK_ADVANCED("Map-Std-Allocator")(Catch::Benchmark::Chronometer meter) {
+        std::map<int, int> map;
+        meter.measure([&] { churn(map); });
+    };
+}
@@ -2,6 +2,8 @@
 #include <algorithm>
 #include <catch2/catch_all.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <iostream>
+#include <optional>
 #include <random>
 
 TEST_CASE("Buddy Allocator - Allocation Speed(Pool vs Malloc)(1024 bytes)",
@@ -162,4 +164,230 @@ TEST_CASE("Buddy Allocator - Fragmentation Pattern",
             }
         });
     };
-}
\ No newline at end of file
+}
+// Same random-order pattern repeated on a long-lived allocator, eager vs deferred coalescing.
+// Eager mode splits and re-merges the same blocks on every round, lazy mode serves the next
+// round straight from the per-level caches.
+TEST_CASE("Buddy Allocator - Fragmentation Pattern (Lazy Coalescing)",
+          "[buddy_allocator][benchmark][fragmentation][lazy]") {
+    const int NUM_ROUNDS = 10;
+    const int NUM_ALLOCATIONS = 1000;
+
+    auto randomOrderRounds = [&](allocator::buddy_allocator& buddy, std::mt19937& rng) {
+        std::vector<void*> ptrs;
+        ptrs.reserve(NUM_ALLOCATIONS);
+
+        for (int round = 0; round < NUM_ROUNDS; ++round) {
+            for (int i = 0; i < NUM_ALLOCATIONS; ++i) {
+                ptrs.push_back(buddy.allocate(1024));
+            }
+
+            std::shuffle(ptrs.begin(), ptrs.end(), rng);
+
+            for (auto ptr : ptrs) {
+                buddy.deallocate(ptr);
+            }
+            ptrs.clear();
+        }
+    };
+
+    BENCHMARK_ADVANCED("Buddy-Random-Order-Eager")(Catch::Benchmark::Chronometer meter) {
+        allocator::buddy_allocator buddy(64 * 1024 * 1024);
+        std::mt19937 rng{42};
+
+        meter.measure([&] { randomOrderRounds(buddy, rng); });
+    };
+
+    BENCHMARK_ADVANCED("Buddy-Random-Order-Lazy")(Catch::Benchmark::Chronometer meter) {
+        allocator::buddy_allocator buddy(64 * 1024 * 1024);
+        buddy.setLazyCoalescing(NUM_ALLOCATIONS);
+        std::mt19937 rng{42};
+
+        meter.measure([&] { randomOrderRounds(buddy, rng); });
+    };
+}
+
+// Pre-allocating the buffers of a batch: one allocate per buffer vs one allocate_n call
+TEST_CASE("Buddy Allocator - Batch Allocation", "[buddy_allocator][benchmark][batch]") {
+    const size_t NUM_BUFFERS = 512;
+    std::vector<void*> ptrs(NUM_BUFFERS);
+
+    BENCHMARK_ADVANCED("Buddy-Batch-4KB-Loop")(Catch::Benchmark::Chronometer meter) {
+        allocator::buddy_allocator buddy(64 * 1024 * 1024);
+
+        meter.measure([&] {
+            for (size_t i = 0; i < NUM_BUFFERS; ++i) {
+                ptrs[i] = buddy.allocate(4096);
+            }
+            for (auto ptr : ptrs) {
+                buddy.deallocate(ptr);
+            }
+        });
+    };
+
+    BENCHMARK_ADVANCED("Buddy-Batch-4KB-Allocate-N")(Catch::Benchmark::Chronometer meter) {
+        allocator::buddy_allocator buddy(64 * 1024 * 1024);
+
+        meter.measure([&] {
+            size_t count = buddy.allocate_n(4096, NUM_BUFFERS, ptrs.data());
+            for (size_t i = 0; i < count; ++i) {
+                buddy.deallocate(ptrs[i]);
+            }
+        });
+    };
+}
+
+// Mixed lifetimes: a few long-lived blocks accumulate while many short-lived ones churn around
+// them. Once the churn is over, the long-lived blocks decide how much contiguous space is left.
+TEST_CASE("Buddy Allocator - Mixed Lifetimes Fragmentation",
+          "[buddy_allocator][benchmark][fragmentation][lifetime]") {
+    using lifetime = allocator::buddy_allocator::lifetime;
+    const int NUM_STEPS = 20000;
+    const size_t LIVE_SHORT = 256;
+
+    auto runMixedLifetimes = [&](allocator::buddy_allocator& buddy,
+                                 std::optional<lifetime> shortHint,
+                                 std::optional<lifetime> longHint) {
+        std::mt19937 rng{7};
+        std::uniform_int_distribution<size_t> sizeDist(1024, 32 * 1024);
+        std::vector<void*> shortLived;
+        std::vector<void*> longLived;
+
+        auto allocate = [&](size_t size, std::optional<lifetime> hint) {
+            return hint ? buddy.allocate(size, *hint) : buddy.allocate(size);
+        };
+
+        for (int step = 0; step < NUM_STEPS; ++step) {
+            if (step % 100 == 0) {
+                longLived.push_back(allocate(sizeDist(rng), longHint));
+            }
+
+            shortLived.push_back(allocate(sizeDist(rng), shortHint));
+            if (shortLived.size() > LIVE_SHORT) {
+                std::uniform_int_distribution<size_t> victim(0, shortLived.size() - 1);
+                std::swap(shortLived[victim(rng)], shortLived.back());
+                buddy.deallocate(shortLived.back());
+                shortLived.pop_back();
+            }
+        }
+
+        for (auto ptr : shortLived) {
+            buddy.deallocate(ptr);
+        }
+        auto stats = buddy.getStats();
+        for (auto ptr : longLived) {
+            buddy.deallocate(ptr);
+        }
+        return stats;
+    };
+
+    SECTION("Largest free block left next to the long-lived data") {
+        allocator::buddy_allocator plain(16 * 1024 * 1024);
+        allocator::buddy_allocator hinted(16 * 1024 * 1024);
+
+        auto plainStats = runMixedLifetimes(plain, std::nullopt, std::nullopt);
+        auto hintedStats =
+            runMixedLifetimes(hinted, lifetime::short_lived, lifetime::long_lived);
+
+        std::cout << "Unhinted: largest free block " << plainStats.largest_free_block / 1024
+                  << " KB, external fragmentation " << plainStats.external_fragmentation << "\n";
+        std::cout << "Hinted:   largest free block " << hintedStats.largest_free_block / 1024
+                  << " KB, external fragmentation " << hintedStats.external_fragmentation
+                  << "\n\n";
+
+        REQUIRE(hintedStats.largest_free_block >= plainStats.largest_free_block);
+    }
+
+    BENCHMARK_ADVANCED("Buddy-Mixed-Lifetimes-Unhinted")(Catch::Benchmark::Chronometer meter) {
+        allocator::buddy_allocator buddy(16 * 1024 * 1024);
+        meter.measure([&] { return runMixedLifetimes(buddy, std::nullopt, std::nullopt); });
+    };
+
+    BENCHMARK_ADVANCED("Buddy-Mixed-Lifetimes-Hinted")(Catch::Benchmark::Chronometer meter) {
+        allocator::buddy_allocator buddy(16 * 1024 * 1024);
+        meter.measure([&] {
+            return runMixedLifetimes(buddy, lifetime::short_lived, lifetime::long_lived);
+        });
+    };
+}
+
+// Internal fragmentation of odd-sized payloads with power-of-two vs weighted (3*2^k) blocks
+TEST_CASE("Buddy Allocator - Weighted Size Classes",
+          "[buddy_allocator][benchmark][fragmentation][weighted]") {
+    using policy = allocator::buddy_allocator::split_policy;
+    const int NUM_ALLOCATIONS = 1000;
+
+    auto randomSizes = [&](allocator::buddy_allocator& buddy) {
+        std::mt19937 rng{11};
+        std::uniform_int_distribution<size_t> sizeDist(1024, 48 * 1024);
+        std::vector<void*> ptrs;
+        ptrs.reserve(NUM_ALLOCATIONS);
+
+        for (int i = 0; i < NUM_ALLOCATIONS; ++i) {
+            ptrs.push_back(buddy.allocate(sizeDist(rng)));
+        }
+        auto stats = buddy.getStats();
+        for (auto ptr : ptrs) {
+            buddy.deallocate(ptr);
+        }
+        return stats;
+    };
+
+    SECTION("Granted vs requested bytes") {
+        allocator::buddy_allocator binary(128 * 1024 * 1024, policy::whole_block);
+        allocator::buddy_allocator weighted(128 * 1024 * 1024, policy::weighted);
+
+        auto binaryStats = randomSizes(binary);
+        auto weightedStats = randomSizes(weighted);
+
+        std::cout << "Power-of-two: internal fragmentation " << binaryStats.internal_fragmentation
+                  << "\n";
+        std::cout << "Weighted:     internal fragmentation "
+                  << weightedStats.internal_fragmentation << "\n\n";
+
+        REQUIRE(weightedStats.internal_fragmentation < binaryStats.internal_fragmentation);
+    }
+
+    BENCHMARK_ADVANCED("Buddy-Random-Sizes-Power-Of-Two")(Catch::Benchmark::Chronometer meter) {
+        allocator::buddy_allocator buddy(128 * 1024 * 1024, policy::whole_block);
+        meter.measure([&] { return randomSizes(buddy); });
+    };
+
+    BENCHMARK_ADVANCED("Buddy-Random-Sizes-Weighted")(Catch::Benchmark::Chronometer meter) {
+        allocator::buddy_allocator buddy(128 * 1024 * 1024, policy::weighted);
+        meter.measure([&] { return randomSizes(buddy); });
+    };
+}
+
+// Small objects freed with and without their size, the sized path skips the allocation map
+TEST_CASE("Buddy Allocator - Sized Deallocation", "[buddy_allocator][benchmark][sized]") {
+    const size_t OBJECT_SIZE = 48;
+    const size_t NUM_OBJECTS = 5000;
+    std::vector<void*> ptrs(NUM_OBJECTS);
+
+    BENCHMARK_ADVANCED("Buddy-48B-Unsized-Free")(Catch::Benchmark::Chronometer meter) {
+        allocator::buddy_allocator buddy(16 * 1024 * 1024);
+
+        meter.measure([&] {
+            for (size_t i = 0; i < NUM_OBJECTS; ++i) {
+                ptrs[i] = buddy.allocate(OBJECT_SIZE);
+            }
+            for (auto ptr : ptrs) {
+                buddy.deallocate(ptr);
+            }
+        });
+    };
+
+    BENCHMARK_ADVANCED("Buddy-48B-Sized-Free")(Catch::Benchmark::Chronometer meter) {
+        allocator::buddy_allocator buddy(16 * 1024 * 1024);
+
+        meter.measure([&] {
+            for (size_t i = 0; i < NUM_OBJECTS; ++i) {
+                ptrs[i] = buddy.allocate(OBJECT_SIZE);
+            }
+            for (auto ptr : ptrs) {
+                buddy.deallocate(ptr, OBJECT_SIZE);
+            }
+        });
+    };
+}
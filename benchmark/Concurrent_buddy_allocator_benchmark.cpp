@@ -0,0 +1,76 @@
+#include "allocator/concurrent_buddy_allocator.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// buddy_allocator behind one mutex, what callers had to do before the concurrent allocator
+class locked_buddy {
+  public:
+    explicit locked_buddy(size_t bufferSize) : m_buddy(bufferSize) {}
+
+    void* allocate(size_t size) {
+        std::lock_guard<std::mutex> guard(m_lock);
+        return m_buddy.allocate(size);
+    }
+
+    void deallocate(void* ptr) {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_buddy.deallocate(ptr);
+    }
+
+  private:
+    std::mutex m_lock;
+    allocator::buddy_allocator m_buddy;
+};
+
+// every thread allocates and frees a small working set of 4KB - 64KB blocks
+template <typename Alloc> void run_threads(Alloc& alloc, int numThreads, int opsPerThread) {
+    auto worker = [&](int seed) {
+        std::vector<void*> ptrs;
+        ptrs.reserve(8);
+        for (int i = 0; i < opsPerThread; i += 8) {
+            for (int j = 0; j < 8; ++j) {
+                ptrs.push_back(alloc.allocate(4096u << ((seed + i + j) % 5)));
+            }
+            for (auto p : ptrs) {
+                alloc.deallocate(p);
+            }
+            ptrs.clear();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back(worker, t);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+} // namespace
+
+// Throughput scaling for page-sized allocations, total work grows with the thread count so a
+// flat time means linear scaling
+TEST_CASE("Concurrent Buddy Allocator - Thread scaling (4KB - 64KB)",
+          "[concurrent_buddy_allocator][threads][comparison]") {
+    const int OPS_PER_THREAD = 20000;
+
+    for (int numThreads : {1, 2, 4, 8}) {
+        BENCHMARK_ADVANCED("Concurrent-Buddy-" + std::to_string(numThreads) + "-threads")(
+            Catch::Benchmark::Chronometer meter) {
+            allocator::concurrent_buddy_allocator buddy(64 * 1024 * 1024);
+            meter.measure([&] { run_threads(buddy, numThreads, OPS_PER_THREAD); });
+        };
+
+        BENCHMARK_ADVANCED("Mutex-Buddy-" + std::to_string(numThreads) + "-threads")(
+            Catch::Benchmark::Chronometer meter) {
+            locked_buddy buddy(64 * 1024 * 1024);
+            meter.measure([&] { run_threads(buddy, numThreads, OPS_PER_THREAD); });
+        };
+    }
+}
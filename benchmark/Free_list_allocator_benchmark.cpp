@@ -0,0 +1,90 @@
+#include "allocator/free_list_allocator.hpp"
+#include "allocator/tlsf_allocator.hpp"
+#include "Workload.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+using fit_policy = allocator::free_list_allocator::fit_policy;
+using workload::make_workload;
+using workload::run_workload;
+
+// largest payload that still fits, found by halving the request
+size_t largest_allocation(allocator::free_list_allocator& freeList) {
+    size_t low = 0;
+    size_t high = 16 * 1024 * 1024;
+    while (low < high) {
+        size_t mid = (low + high + 1) / 2;
+        void* ptr = freeList.allocate(mid);
+        if (ptr) {
+            freeList.deallocate(ptr);
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return low;
+}
+
+} // namespace
+
+// The policies trade search time for fragmentation on the same workload
+TEST_CASE("Free List Allocator - Fit Policies (First vs Next vs Best vs TLSF)",
+          "[free_list_allocator][comparison][speed]") {
+    const auto ops = make_workload(4000, 2048);
+    std::vector<void*> live;
+    live.reserve(ops.size());
+
+    auto benchmarkPolicy = [&](const char* name, fit_policy policy) {
+        BENCHMARK_ADVANCED(name)(Catch::Benchmark::Chronometer meter) {
+            allocator::free_list_allocator freeList(16 * 1024 * 1024, policy);
+            meter.measure([&] {
+                run_workload(
+                    ops, live, [&](size_t size) { return freeList.allocate(size); },
+                    [&](void* ptr) { freeList.deallocate(ptr); });
+            });
+        };
+    };
+
+    benchmarkPolicy("FirstFit-Variable-Sizes", fit_policy::first_fit);
+    benchmarkPolicy("NextFit-Variable-Sizes", fit_policy::next_fit);
+    benchmarkPolicy("BestFit-Variable-Sizes", fit_policy::best_fit);
+
+    BENCHMARK_ADVANCED("TLSF-Variable-Sizes")(Catch::Benchmark::Chronometer meter) {
+        allocator::tlsf_allocator tlsf(16 * 1024 * 1024);
+        meter.measure([&] {
+            run_workload(
+                ops, live, [&](size_t size) { return tlsf.allocate(size); },
+                [&](void* ptr) { tlsf.deallocate(ptr); });
+        });
+    };
+}
+
+// Fragmentation left behind by each policy: free blocks and largest allocation at the end of a
+// long run that fills most of a small buffer
+TEST_CASE("Free List Allocator - Fragmentation by Policy", "[free_list_allocator][fragmentation]") {
+    const auto ops = make_workload(20000, 2048);
+
+    for (auto [name, policy] : {std::pair{"first fit", fit_policy::first_fit},
+                                std::pair{"next fit ", fit_policy::next_fit},
+                                std::pair{"best fit ", fit_policy::best_fit}}) {
+        allocator::free_list_allocator freeList(16 * 1024 * 1024, policy);
+        std::vector<void*> live;
+        workload::replay(
+            ops, live, [&](size_t size) { return freeList.allocate(size); },
+            [&](void* ptr) { freeList.deallocate(ptr); });
+
+        std::cout << name << ": " << freeList.getFreeBlockCount() << " free blocks, largest "
+                  << largest_allocation(freeList) / 1024 << " KB, "
+                  << freeList.getAllocatedSize() / 1024 << " KB live\n";
+
+        for (auto ptr : live) {
+            freeList.deallocate(ptr);
+        }
+        REQUIRE(freeList.getFreeBlockCount() == 1);
+    }
+    std::cout << "\n";
+}
@@ -0,0 +1,38 @@
+#include "allocator/buddy_allocator.hpp"
+#include "allocator/pmr_resource.hpp"
+#include "allocator/pool_allocator.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <list>
+#include <vector>
+
+// Node-based pmr container: every push and pop is one allocation or deallocation
+TEST_CASE("pmr resource - List Churn (Pool vs Buddy vs new/delete)", "[pmr_resource][speed]") {
+    const int NUM_NODES = 5000;
+
+    auto churn = [&](std::pmr::memory_resource* resource) {
+        std::pmr::list<int> values(resource);
+        for (int i = 0; i < NUM_NODES; ++i) {
+            values.push_back(i);
+        }
+        while (!values.empty()) {
+            values.pop_front();
+        }
+    };
+
+    BENCHMARK_ADVANCED("Pmr-List-Pool")(Catch::Benchmark::Chronometer meter) {
+        allocator::pool_allocator pool(sizeof(std::pmr::list<int>::value_type) + 16, NUM_NODES);
+        allocator::pmr_resource resource(pool);
+        meter.measure([&] { churn(&resource); });
+    };
+
+    BENCHMARK_ADVANCED("Pmr-List-Buddy")(Catch::Benchmark::Chronometer meter) {
+        allocator::buddy_allocator buddy(16 * 1024 * 1024);
+        allocator::pmr_resource resource(buddy);
+        meter.measure([&] { churn(&resource); });
+    };
+
+    BENCHMARK_ADVANCED("Pmr-List-New-Delete")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] { churn(std::pmr::new_delete_resource()); });
+    };
+}
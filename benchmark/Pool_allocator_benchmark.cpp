@@ -182,4 +182,63 @@ TEST_CASE("Pool Allocator - Alignment Overhead", "[pool_allocator][alignmentOver
             std::cerr << "--------------------------------------------------" << std::endl;
         }
     }
-}
\ No newline at end of file
+}
+// Same loop through the concrete type (inlined fast path) and through AllocatorInterface
+TEST_CASE("Pool Allocator - Static vs Virtual Calls", "[pool_allocator][static]") {
+    const size_t OBJECT_SIZE = 64;
+    const size_t NUM_OBJECTS = 5000;
+
+    auto churn = [&](auto& alloc, std::vector<void*>& ptrs) {
+        for (size_t i = 0; i < NUM_OBJECTS; ++i) {
+            ptrs.push_back(alloc.allocate(OBJECT_SIZE, 0));
+        }
+        for (auto ptr : ptrs) {
+            alloc.deallocate(ptr);
+        }
+        ptrs.clear();
+    };
+
+    BENCHMARK_ADVANCED("Pool static calls")(Catch::Benchmark::Chronometer meter) {
+        allocator::pool_allocator pool(OBJECT_SIZE, NUM_OBJECTS);
+        std::vector<void*> ptrs;
+        ptrs.reserve(NUM_OBJECTS);
+        meter.measure([&] { churn(pool, ptrs); });
+    };
+
+    BENCHMARK_ADVANCED("Pool virtual calls")(Catch::Benchmark::Chronometer meter) {
+        std::unique_ptr<allocator::AllocatorInterface> pool =
+            std::make_unique<allocator::pool_allocator>(OBJECT_SIZE, NUM_OBJECTS);
+        std::vector<void*> ptrs;
+        ptrs.reserve(NUM_OBJECTS);
+        meter.measure([&] { churn(*pool, ptrs); });
+    };
+}
+
+// Cost of the deallocation checks: unchecked, checked (the release default) and paranoid, which
+// walks the free list for a double free on every call
+TEST_CASE("Pool Allocator - Deallocation Check Policies", "[pool_allocator][policy]") {
+    using allocator::check_policy;
+    const size_t OBJECT_SIZE = 64;
+    const size_t NUM_OBJECTS = 1000;
+
+    auto benchmarkPolicy = [&]<check_policy Policy>(const char* name) {
+        BENCHMARK_ADVANCED(name)(Catch::Benchmark::Chronometer meter) {
+            allocator::pool_allocator pool(OBJECT_SIZE, NUM_OBJECTS);
+            std::vector<void*> ptrs;
+            ptrs.reserve(NUM_OBJECTS);
+            meter.measure([&] {
+                for (size_t i = 0; i < NUM_OBJECTS; ++i) {
+                    ptrs.push_back(pool.allocate());
+                }
+                for (auto ptr : ptrs) {
+                    pool.deallocate<Policy>(ptr);
+                }
+                ptrs.clear();
+            });
+        };
+    };
+
+    benchmarkPolicy.operator()<check_policy::unchecked>("Pool unchecked deallocate");
+    benchmarkPolicy.operator()<check_policy::checked>("Pool checked deallocate");
+    benchmarkPolicy.operator()<check_policy::paranoid>("Pool paranoid deallocate");
+}
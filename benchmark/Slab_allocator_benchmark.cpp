@@ -0,0 +1,54 @@
+#include "allocator/pool_allocator.hpp"
+#include "allocator/slab_allocator.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace {
+// an object whose initialisation is worth caching: a lock and a zeroed scratch buffer
+struct session {
+    std::mutex lock;
+    char scratch[1024];
+
+    session() { std::memset(scratch, 0, sizeof(scratch)); }
+};
+} // namespace
+
+// Construct once per slot (slab cache) vs construct and destroy on every use (pool + placement
+// new), with a working set that is freed and reused every round
+TEST_CASE("Slab Allocator - Object Caching (Slab vs Pool)", "[slab_allocator][comparison][speed]") {
+    const size_t NUM_OBJECTS = 1000;
+    std::vector<session*> objects(NUM_OBJECTS);
+
+    BENCHMARK_ADVANCED("Slab-Cached-Objects")(Catch::Benchmark::Chronometer meter) {
+        allocator::slab_allocator slabs(
+            sizeof(session), alignof(session), [](void* p) { new (p) session(); },
+            [](void* p) { static_cast<session*>(p)->~session(); });
+
+        meter.measure([&] {
+            for (auto& object : objects) {
+                object = static_cast<session*>(slabs.allocate());
+            }
+            for (auto object : objects) {
+                slabs.deallocate(object);
+            }
+        });
+    };
+
+    BENCHMARK_ADVANCED("Pool-Construct-Per-Use")(Catch::Benchmark::Chronometer meter) {
+        allocator::pool_allocator pool(sizeof(session), NUM_OBJECTS, alignof(session));
+
+        meter.measure([&] {
+            for (auto& object : objects) {
+                object = new (pool.allocate()) session();
+            }
+            for (auto object : objects) {
+                object->~session();
+                pool.deallocate(object);
+            }
+        });
+    };
+}
@@ -192,4 +192,62 @@ TEST_CASE("stack Allocator - Alignment Overhead", "[stack_allocator][alignmentOv
             std::cerr << "--------------------------------------------------" << std::endl;
         }
     }
-}
\ No newline at end of file
+}
+// Same loop through the concrete type (inlined fast path) and through AllocatorInterface
+TEST_CASE("stack Allocator - Static vs Virtual Calls", "[stack_allocator][static]") {
+    const size_t OBJECT_SIZE = 64;
+    const size_t NUM_OBJECTS = 5000;
+
+    auto churn = [&](auto& alloc, std::vector<void*>& ptrs) {
+        for (size_t i = 0; i < NUM_OBJECTS; ++i) {
+            ptrs.push_back(alloc.allocate(OBJECT_SIZE, 0));
+        }
+        for (auto it = ptrs.rbegin(); it != ptrs.rend(); ++it) {
+            alloc.deallocate(*it);
+        }
+        ptrs.clear();
+    };
+
+    BENCHMARK_ADVANCED("Stack static calls")(Catch::Benchmark::Chronometer meter) {
+        allocator::stack_allocator stack(OBJECT_SIZE * NUM_OBJECTS);
+        std::vector<void*> ptrs;
+        ptrs.reserve(NUM_OBJECTS);
+        meter.measure([&] { churn(stack, ptrs); });
+    };
+
+    BENCHMARK_ADVANCED("Stack virtual calls")(Catch::Benchmark::Chronometer meter) {
+        std::unique_ptr<allocator::AllocatorInterface> stack =
+            std::make_unique<allocator::stack_allocator>(OBJECT_SIZE * NUM_OBJECTS);
+        std::vector<void*> ptrs;
+        ptrs.reserve(NUM_OBJECTS);
+        meter.measure([&] { churn(*stack, ptrs); });
+    };
+}
+
+// Cost of the deallocation checks: unchecked, checked (the release default) and paranoid
+TEST_CASE("stack Allocator - Deallocation Check Policies", "[stack_allocator][policy]") {
+    using allocator::check_policy;
+    const size_t OBJECT_SIZE = 64;
+    const size_t NUM_OBJECTS = 5000;
+
+    auto benchmarkPolicy = [&]<check_policy Policy>(const char* name) {
+        BENCHMARK_ADVANCED(name)(Catch::Benchmark::Chronometer meter) {
+            allocator::stack_allocator stack(OBJECT_SIZE * NUM_OBJECTS);
+            std::vector<void*> ptrs;
+            ptrs.reserve(NUM_OBJECTS);
+            meter.measure([&] {
+                for (size_t i = 0; i < NUM_OBJECTS; ++i) {
+                    ptrs.push_back(stack.allocate(OBJECT_SIZE));
+                }
+                for (auto it = ptrs.rbegin(); it != ptrs.rend(); ++it) {
+                    stack.deallocate<Policy>(*it);
+                }
+                ptrs.clear();
+            });
+        };
+    };
+
+    benchmarkPolicy.operator()<check_policy::unchecked>("Stack unchecked deallocate");
+    benchmarkPolicy.operator()<check_policy::checked>("Stack checked deallocate");
+    benchmarkPolicy.operator()<check_policy::paranoid>("Stack paranoid deallocate");
+}
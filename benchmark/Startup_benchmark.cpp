@@ -0,0 +1,110 @@
+#include "allocator/buddy_allocator.hpp"
+#include "allocator/memory_provider.hpp"
+#include "allocator/pool_allocator.hpp"
+#include "allocator/stack_allocator.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+
+namespace {
+constexpr size_t MB = 1024 * 1024;
+
+// the buffers as std::make_unique<std::byte[]> used to hand them over, value-initialized
+class zeroing_provider final : public allocator::memory_provider {
+  public:
+    void* acquire(size_t size, size_t alignment) noexcept override {
+        void* ptr = ::operator new(size, std::align_val_t{alignment}, std::nothrow);
+        if (ptr) {
+            std::memset(ptr, 0, size);
+        }
+        return ptr;
+    }
+    void release(void* ptr, size_t, size_t alignment) noexcept override {
+        ::operator delete(ptr, std::align_val_t{alignment});
+    }
+};
+
+// resident set of the process, 0 where /proc is not available
+size_t resident_bytes() {
+    size_t total = 0, resident = 0;
+    std::ifstream("/proc/self/statm") >> total >> resident;
+    return resident * allocator::memory_provider::page_size();
+}
+
+// construction time and the resident memory the allocator holds right after it
+template <typename Make> void report_startup(const char* name, Make make) {
+    size_t before = resident_bytes();
+    auto start = std::chrono::steady_clock::now();
+    auto alloc = make();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    size_t resident = resident_bytes() - before;
+
+    std::cout << std::left << std::setw(28) << name
+              << std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()
+              << " us, " << resident / MB << " MB resident\n";
+}
+} // namespace
+
+// A 64MB stack, a 64MB pool and a 128MB buddy allocator built on zeroed buffers (as before)
+// and on uninitialized ones (the default), the latter only take pages as they are used
+TEST_CASE("Startup - Construction of large allocators", "[startup][benchmark]") {
+    using buddy = allocator::buddy_allocator;
+    zeroing_provider zeroed;
+    allocator::memory_provider* uninitialized = allocator::default_memory_provider();
+    allocator::mmap_provider mapped;
+
+    std::cout << "\nStartup of large allocators:\n";
+    report_startup("stack 64MB, zeroed", [&] {
+        return std::make_unique<allocator::stack_allocator>(64 * MB, 0, false, &zeroed);
+    });
+    report_startup("stack 64MB, uninitialized", [&] {
+        return std::make_unique<allocator::stack_allocator>(64 * MB, 0, false, uninitialized);
+    });
+    report_startup("pool 64MB, zeroed", [&] {
+        return std::make_unique<allocator::pool_allocator>(64, MB, 0, 0, &zeroed);
+    });
+    report_startup("pool 64MB, uninitialized", [&] {
+        return std::make_unique<allocator::pool_allocator>(64, MB, 0, 0, uninitialized);
+    });
+    report_startup("buddy 128MB, zeroed", [&] {
+        return std::make_unique<buddy>(128 * MB, buddy::split_policy::whole_block,
+                                       buddy::buffer_mode::heap, &zeroed);
+    });
+    report_startup("buddy 128MB, uninitialized", [&] {
+        return std::make_unique<buddy>(128 * MB, buddy::split_policy::whole_block,
+                                       buddy::buffer_mode::heap, uninitialized);
+    });
+    report_startup("buddy 128MB, mmap", [&] {
+        return std::make_unique<buddy>(128 * MB, buddy::split_policy::whole_block,
+                                       buddy::buffer_mode::heap, &mapped);
+    });
+    std::cout << "\n";
+
+    BENCHMARK("stack 64MB, zeroed") {
+        return allocator::stack_allocator(64 * MB, 0, false, &zeroed).getAllocatedSize();
+    };
+    BENCHMARK("stack 64MB, uninitialized") {
+        return allocator::stack_allocator(64 * MB, 0, false, uninitialized).getAllocatedSize();
+    };
+    BENCHMARK("pool 64MB, zeroed") {
+        return allocator::pool_allocator(64, MB, 0, 0, &zeroed).getAllocatedSize();
+    };
+    BENCHMARK("pool 64MB, uninitialized") {
+        return allocator::pool_allocator(64, MB, 0, 0, uninitialized).getAllocatedSize();
+    };
+    BENCHMARK("buddy 128MB, zeroed") {
+        return buddy(128 * MB, buddy::split_policy::whole_block, buddy::buffer_mode::heap,
+                     &zeroed)
+            .getAllocatedSize();
+    };
+    BENCHMARK("buddy 128MB, uninitialized") {
+        return buddy(128 * MB, buddy::split_policy::whole_block, buddy::buffer_mode::heap,
+                     uninitialized)
+            .getAllocatedSize();
+    };
+}
@@ -0,0 +1,95 @@
+#include "allocator/buddy_allocator.hpp"
+#include "allocator/tlsf_allocator.hpp"
+#include "Workload.hpp"
+#include <algorithm>
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+using workload::make_workload;
+using workload::run_workload;
+} // namespace
+
+// Random sizes and random free order, the general-purpose case TLSF is meant for
+TEST_CASE("TLSF Allocator - Variable Sizes (TLSF vs Buddy vs Malloc)",
+          "[tlsf_allocator][comparison][speed]") {
+    const auto ops = make_workload(20000, 4096);
+    std::vector<void*> live;
+    live.reserve(ops.size());
+
+    BENCHMARK_ADVANCED("TLSF-Variable-Sizes")(Catch::Benchmark::Chronometer meter) {
+        allocator::tlsf_allocator tlsf(64 * 1024 * 1024);
+        meter.measure([&] {
+            run_workload(
+                ops, live, [&](size_t size) { return tlsf.allocate(size); },
+                [&](void* ptr) { tlsf.deallocate(ptr); });
+        });
+    };
+
+    BENCHMARK_ADVANCED("Buddy-Variable-Sizes")(Catch::Benchmark::Chronometer meter) {
+        allocator::buddy_allocator buddy(64 * 1024 * 1024);
+        meter.measure([&] {
+            run_workload(
+                ops, live, [&](size_t size) { return buddy.allocate(size); },
+                [&](void* ptr) { buddy.deallocate(ptr); });
+        });
+    };
+
+    BENCHMARK_ADVANCED("Malloc-Variable-Sizes")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] {
+            run_workload(
+                ops, live, [](size_t size) { return std::malloc(size); },
+                [](void* ptr) { std::free(ptr); });
+        });
+    };
+}
+
+// Worst-case latency matters more than the average on a deadline, so time every single call
+// and report the tail
+TEST_CASE("TLSF Allocator - Latency Tail (TLSF vs Malloc)", "[tlsf_allocator][latency]") {
+    const auto ops = make_workload(200000, 64 * 1024);
+    std::vector<void*> live;
+    live.reserve(ops.size());
+
+    auto measureTail = [&](const char* name, auto alloc, auto free) {
+        std::vector<std::chrono::nanoseconds> samples;
+        samples.reserve(ops.size());
+
+        for (const auto& op : ops) {
+            auto begin = std::chrono::steady_clock::now();
+            if (op.allocate) {
+                live.push_back(alloc(op.size));
+            } else {
+                std::swap(live[op.index], live.back());
+                free(live.back());
+            }
+            samples.push_back(std::chrono::steady_clock::now() - begin);
+            if (!op.allocate) {
+                live.pop_back();
+            }
+        }
+        for (auto ptr : live) {
+            free(ptr);
+        }
+        live.clear();
+
+        std::sort(samples.begin(), samples.end());
+        auto percentile = [&](double p) {
+            return samples[static_cast<size_t>(p * static_cast<double>(samples.size() - 1))]
+                .count();
+        };
+        std::cout << name << ": p50 " << percentile(0.5) << " ns, p99.9 " << percentile(0.999)
+                  << " ns, max " << samples.back().count() << " ns\n";
+    };
+
+    allocator::tlsf_allocator tlsf(128 * 1024 * 1024);
+    measureTail(
+        "TLSF  ", [&](size_t size) { return tlsf.allocate(size); },
+        [&](void* ptr) { tlsf.deallocate(ptr); });
+    measureTail(
+        "Malloc", [](size_t size) { return std::malloc(size); }, [](void* ptr) { std::free(ptr); });
+    std::cout << "\n";
+}
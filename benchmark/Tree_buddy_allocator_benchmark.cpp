@@ -0,0 +1,66 @@
+#include "allocator/buddy_allocator.hpp"
+#include "allocator/tree_buddy_allocator.hpp"
+#include <algorithm>
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+
+// Same random-order churn as the buddy fragmentation benchmark, in-band free lists and a hash
+// map versus the out-of-band longest-free-run tree
+TEST_CASE("Tree Buddy Allocator - Random Order (Tree vs Buddy)",
+          "[tree_buddy_allocator][comparison][fragmentation]") {
+    const int NUM_ALLOCATIONS = 1000;
+
+    BENCHMARK_ADVANCED("Tree-Buddy-Random-Order")(Catch::Benchmark::Chronometer meter) {
+        allocator::tree_buddy_allocator tree(64 * 1024 * 1024);
+        std::mt19937 rng{42};
+        std::vector<void*> ptrs;
+        ptrs.reserve(NUM_ALLOCATIONS);
+
+        meter.measure([&] {
+            for (int i = 0; i < NUM_ALLOCATIONS; ++i) {
+                ptrs.push_back(tree.allocate(1024));
+            }
+            std::shuffle(ptrs.begin(), ptrs.end(), rng);
+            for (auto ptr : ptrs) {
+                tree.deallocate(ptr);
+            }
+            ptrs.clear();
+        });
+    };
+
+    BENCHMARK_ADVANCED("Buddy-Random-Order")(Catch::Benchmark::Chronometer meter) {
+        allocator::buddy_allocator buddy(64 * 1024 * 1024);
+        std::mt19937 rng{42};
+        std::vector<void*> ptrs;
+        ptrs.reserve(NUM_ALLOCATIONS);
+
+        meter.measure([&] {
+            for (int i = 0; i < NUM_ALLOCATIONS; ++i) {
+                ptrs.push_back(buddy.allocate(1024));
+            }
+            std::shuffle(ptrs.begin(), ptrs.end(), rng);
+            for (auto ptr : ptrs) {
+                buddy.deallocate(ptr);
+            }
+            ptrs.clear();
+        });
+    };
+
+    // abstract ranges: 1TB of 4KB pages, no backing memory at all
+    BENCHMARK_ADVANCED("Tree-Buddy-Abstract-Ranges")(Catch::Benchmark::Chronometer meter) {
+        allocator::tree_buddy_allocator ranges(1ull << 40, 1ull << 16, false);
+        std::vector<size_t> offsets;
+        offsets.reserve(NUM_ALLOCATIONS);
+
+        meter.measure([&] {
+            for (int i = 0; i < NUM_ALLOCATIONS; ++i) {
+                offsets.push_back(ranges.allocate_range(1ull << 16));
+            }
+            for (auto offset : offsets) {
+                ranges.deallocate_range(offset);
+            }
+            offsets.clear();
+        });
+    };
+}
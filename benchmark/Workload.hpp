@@ -0,0 +1,67 @@
+#ifndef BENCHMARK_WORKLOAD_HPP
+#define BENCHMARK_WORKLOAD_HPP
+
+#include <cstddef>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Variable-size workloads shared by the benchmarks of the general-purpose allocators, so each
+// allocator is measured on the same sequence of requests
+namespace workload {
+
+// one step of a variable-size workload: allocate a size or free a live block
+struct operation {
+    bool allocate;
+    size_t size;  // allocation size
+    size_t index; // live block to free
+};
+
+// steps random allocations of 16..maxSize bytes and frees in random order, the same sequence on
+// every call
+inline std::vector<operation> make_workload(int steps, size_t maxSize) {
+    std::mt19937 rng{2024};
+    std::uniform_int_distribution<size_t> sizeDist(16, maxSize);
+    std::vector<operation> ops;
+    size_t live = 0;
+
+    for (int i = 0; i < steps; ++i) {
+        if (live == 0 || rng() % 2 == 0) {
+            ops.push_back({true, sizeDist(rng), 0});
+            ++live;
+        } else {
+            ops.push_back({false, 0, rng() % live});
+            --live;
+        }
+    }
+    return ops;
+}
+
+// replays ops, the blocks still allocated at the end are left in live
+template <typename Alloc, typename Free>
+void replay(const std::vector<operation>& ops, std::vector<void*>& live, Alloc alloc, Free free) {
+    for (const auto& op : ops) {
+        if (op.allocate) {
+            live.push_back(alloc(op.size));
+        } else {
+            std::swap(live[op.index], live.back());
+            free(live.back());
+            live.pop_back();
+        }
+    }
+}
+
+// replays ops and frees what is left, the allocator ends up empty
+template <typename Alloc, typename Free>
+void run_workload(const std::vector<operation>& ops, std::vector<void*>& live, Alloc alloc,
+                  Free free) {
+    replay(ops, live, alloc, free);
+    for (auto ptr : live) {
+        free(ptr);
+    }
+    live.clear();
+}
+
+} // namespace workload
+
+#endif // BENCHMARK_WORKLOAD_HPP
@@ -1,13 +1,68 @@
+#ifndef ALLOCATOR_INTERFACE_HPP
+#define ALLOCATOR_INTERFACE_HPP
+
+#include <concepts>
+#include <expected>
 #include <memory>
+#include <new>
 #include <string>
+#include <type_traits>
 
 namespace allocator {
+
+#if defined(__cpp_lib_allocate_at_least)
+template <typename Pointer> using allocation_result = std::allocation_result<Pointer>;
+#else
+// stand-in for the C++23 std::allocation_result until the standard library provides it
+template <typename Pointer> struct allocation_result {
+    Pointer ptr;
+    size_t count;
+};
+#endif
+
+// why try_allocate could not serve a request
+enum class alloc_error {
+    out_of_memory,     // no free block is large enough
+    capacity_exceeded, // growing would pass the allocator's limits
+    size_too_large,    // larger than the allocator can ever serve
+    invalid_alignment, // not a power of two, or not supported by the allocator
+    no_memory          // the allocator has released its memory
+};
+
 class AllocatorInterface {
   public:
     virtual ~AllocatorInterface() = default;
 
     virtual void* allocate(size_t size, size_t alignment = 0) = 0;
+
+    // Like allocate, but failures come back as an error code: never throws and never builds a
+    // message, whatever the build type. allocate is a wrapper that reports the error. The
+    // default catches what allocate throws, the allocators of this project override it.
+    virtual std::expected<void*, alloc_error> try_allocate(size_t size,
+                                                           size_t alignment = 0) noexcept {
+        try {
+            if (void* ptr = allocate(size, alignment)) {
+                return ptr;
+            }
+        } catch (...) {
+        }
+        return std::unexpected(alloc_error::out_of_memory);
+    }
+
+    // Like allocate, but also reports how many bytes the caller may use, which can be more than
+    // size when the allocator rounds requests up. By default exactly size.
+    virtual allocation_result<void*> allocate_at_least(size_t size, size_t alignment = 0) {
+        void* ptr = allocate(size, alignment);
+        return {ptr, ptr ? size : 0};
+    }
     virtual void deallocate(void* ptr) = 0;
+
+    // Sized deallocation, size and alignment being those passed to allocate. Allocators that
+    // can skip a metadata lookup with them override it, by default the size is ignored.
+    virtual void deallocate(void* ptr, [[maybe_unused]] size_t size,
+                            [[maybe_unused]] size_t alignment = 0) {
+        deallocate(ptr);
+    }
     virtual size_t getAllocatedSize() const = 0;
     virtual size_t getObjectSize() const = 0;
     virtual void reset() = 0;
@@ -29,6 +84,23 @@ class AllocatorInterface {
         return (alignment != 0) && ((alignment & (alignment - 1)) == 0);
     }
 
+    // message for allocate when try_allocate failed, built on that path only
+    static std::string describeAllocationError(alloc_error error, size_t size) {
+        switch (error) {
+        case alloc_error::capacity_exceeded:
+            return "Exceeds maximum capacity, cannot grow for allocation(" +
+                   std::to_string(size) + ")";
+        case alloc_error::size_too_large:
+            return "Requested size(" + std::to_string(size) + ") exceeds largest block size";
+        case alloc_error::invalid_alignment:
+            return "Alignment must be a power of two supported by the allocator";
+        case alloc_error::no_memory:
+            return "Allocator has released its memory";
+        default:
+            return "No sufficient block available for allocation(" + std::to_string(size) + ")";
+        }
+    }
+
     // make error handling configurable. In debug mode, throw detailed exceptions.
     // In release mode, throw std::bad_alloc for allocation failures.
     static void throwAllocationError([[maybe_unused]] std::string allocationType,
@@ -41,25 +113,132 @@ class AllocatorInterface {
     }
 };
 
+// Validation done when a block is given back, chosen at compile time. The allocators with
+// inline fast paths take it as a template argument of deallocate, deallocate(ptr) uses the
+// build's default. A call site that trusts its pointers asks for unchecked, while debug builds
+// and canary builds (ALLOCATOR_PARANOID) verify every free from the same source.
+enum class check_policy {
+    unchecked, // no validation at all, an invalid pointer is undefined behaviour
+    checked,   // null, foreign and misplaced pointers throw
+    paranoid   // checked, plus double free and free order detection, may be O(n)
+};
+
+#if ALLOCATOR_DEBUG || ALLOCATOR_PARANOID
+inline constexpr check_policy default_check_policy = check_policy::paranoid;
+#else
+inline constexpr check_policy default_check_policy = check_policy::checked;
+#endif
+
+// What templated code needs from an allocator. Calls through a concrete type that models it are
+// bound statically, so a fast path defined in the header can be inlined into the caller.
+template <typename A>
+concept Allocator = requires(A& alloc, const A& view, void* ptr, size_t size, size_t alignment) {
+    { alloc.allocate(size, alignment) } -> std::same_as<void*>;
+    alloc.deallocate(ptr);
+    { view.getAllocatedSize() } -> std::same_as<size_t>;
+    { view.getObjectSize() } -> std::same_as<size_t>;
+    alloc.reset();
+};
+
+// CRTP base for allocators with inline fast paths. Derived is final, so its overrides of the
+// AllocatorInterface functions are called directly (and inlined) on the concrete type, while an
+// AllocatorInterface* still reaches them through the vtable. The helpers below build on the
+// static calls.
+template <typename Derived> class allocator_base : public AllocatorInterface {
+  public:
+    // allocate and construct a T, nullptr when the allocator is out of memory
+    template <typename T, typename... Args> [[nodiscard]] T* create(Args&&... args) {
+        void* ptr = derived().allocate(sizeof(T), alignof(T));
+        return ptr ? ::new (ptr) T(std::forward<Args>(args)...) : nullptr;
+    }
+
+    template <typename T> void destroy(T* ptr) {
+        ptr->~T();
+        derived().deallocate(ptr);
+    }
+
+  protected:
+    allocator_base() { static_assert(Allocator<Derived>); }
+
+  private:
+    Derived& derived() { return static_cast<Derived&>(*this); }
+};
+
 // Adapter class for using AllocatorInterface with standard STL containers.
 // enable custom memory allocation in this project. This version was generated with the
 // help of AI and serves as a learning and testing tool while I deepen my
-// understanding of STL allocators(9th september 2025). Future updates may refine this to achieve
-// full allocator compliance and improved performance.
-
+// understanding of STL allocators(9th september 2025). It now meets the allocator requirements:
+// it rebinds, compares equal when it uses the same allocators and follows the container on
+// copy, move and swap.
+//
+// Node routing: with a node allocator (a pool_allocator sized for the container's nodes), every
+// single-element allocation that fits its blocks goes there, while arrays (vector storage,
+// hash buckets) go to the general allocator. Inserts and erases of std::list, std::map or
+// std::unordered_map then cost a pool pop and push.
 template <typename T> class AllocatorAdapter {
   public:
     using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    explicit AllocatorAdapter(AllocatorInterface* alloc, AllocatorInterface* nodeAlloc = nullptr)
+        : allocator_(alloc), nodeAllocator_(nodeAlloc),
+          nodeSize_(nodeAlloc ? nodeAlloc->getObjectSize() : 0) {}
 
-    explicit AllocatorAdapter(AllocatorInterface* alloc) : allocator_(alloc) {}
+    // rebind: containers convert the adapter to their node or bucket type
+    template <typename U>
+    AllocatorAdapter(const AllocatorAdapter<U>& other) noexcept
+        : allocator_(other.allocator_), nodeAllocator_(other.nodeAllocator_),
+          nodeSize_(other.nodeSize_) {}
 
     T* allocate(size_t n) {
-        return static_cast<T*>(allocator_->allocate(n * sizeof(T), alignof(T)));
+        auto result = is_node(n) ? nodeAllocator_->try_allocate(sizeof(T), alignof(T))
+                                 : allocator_->try_allocate(n * sizeof(T), alignof(T));
+        if (!result) {
+            throw std::bad_alloc(); // containers expect an exception, not nullptr
+        }
+        return static_cast<T*>(*result);
+    }
+
+    // picked up by std::allocator_traits::allocate_at_least, containers can use the slack
+    allocation_result<T*> allocate_at_least(size_t n) {
+        if (is_node(n)) {
+            return {allocate(n), n};
+        }
+        auto [ptr, bytes] = allocator_->allocate_at_least(n * sizeof(T), alignof(T));
+        if (!ptr) {
+            throw std::bad_alloc();
+        }
+        return {static_cast<T*>(ptr), bytes / sizeof(T)};
     }
 
-    void deallocate(T* ptr, size_t) { allocator_->deallocate(ptr); }
+    void deallocate(T* ptr, size_t n) {
+        if (is_node(n)) {
+            nodeAllocator_->deallocate(ptr, sizeof(T), alignof(T));
+        } else {
+            allocator_->deallocate(ptr, n * sizeof(T), alignof(T));
+        }
+    }
+
+    // memory from one can be freed by the other when both route to the same allocators
+    template <typename U> bool operator==(const AllocatorAdapter<U>& other) const noexcept {
+        return allocator_ == other.allocator_ && nodeAllocator_ == other.nodeAllocator_;
+    }
 
   private:
+    template <typename U> friend class AllocatorAdapter;
+
+    // pool blocks are at least word aligned, stricter types stay with the general allocator
+    bool is_node(size_t n) const {
+        return n == 1 && sizeof(T) <= nodeSize_ && alignof(T) <= alignof(void*);
+    }
+
     AllocatorInterface* allocator_;
+    AllocatorInterface* nodeAllocator_; // single nodes, nullptr when not routing
+    size_t nodeSize_;                   // block size of the node allocator
 };
-} // namespace allocator
\ No newline at end of file
+} // namespace allocator
+
+#endif // ALLOCATOR_INTERFACE_HPP
@@ -2,74 +2,313 @@
 #define BUDDY_ALLOCATOR_HPP
 
 #include "allocator/allocator_interface.hpp"
+#include "allocator/memory_provider.hpp"
+#include <algorithm>
 #include <array>
+#include <bit>
+#include <cstdint>
 #include <list>
 #include <unordered_map>
+#include <vector>
 
 namespace allocator {
-class buddy_allocator : public allocator::AllocatorInterface {
+class buddy_allocator final : public allocator_base<buddy_allocator> {
   public:
-    buddy_allocator(size_t bufferSize);
+    // how a request is carved out of its power-of-two block
+    enum class split_policy {
+        whole_block, // the request owns the whole power-of-two block
+        trim_tail,   // unused trailing buddies go back to the free lists (600KB -> 512+64+16+8)
+        weighted     // sizes 2^k or 3*2^k: a block of 4 units is split 3+1 (5KB -> 6KB, not 8KB)
+    };
+
+    // where the buffer comes from when the allocator is given no memory_provider
+    enum class buffer_mode {
+        heap, // operator new
+        mmap  // anonymous mapping, the pages of free blocks can be returned to the OS
+    };
+
+    // expected lifetime of an allocation, used to keep long-lived data away from churn
+    enum class lifetime {
+        short_lived, // served from the high end of the buffer
+        long_lived   // served from the low end of the buffer
+    };
+
+    // O(1) snapshot of the allocator state, all counters are maintained on the hot path
+    struct buddy_stats {
+        size_t allocated_bytes = 0;           // granted to live allocations
+        size_t requested_bytes = 0;           // asked for by live allocations
+        size_t free_bytes = 0;                // sitting in the free lists
+        size_t cached_bytes = 0;              // freed but not yet coalesced (lazy mode)
+        size_t slab_bytes = 0;                // minimum blocks carved into small-object slabs
+        size_t largest_free_block = 0;        // biggest request served without merging
+        std::array<size_t, 18> free_blocks{}; // free block count per level
+        double internal_fragmentation = 0.0;  // 1 - requested / granted
+        double external_fragmentation = 0.0;  // 1 - largest free block / free bytes
+    };
+
+    // the buffer comes from provider, or from the one mode names when null
+    explicit buddy_allocator(size_t bufferSize, split_policy policy = split_policy::whole_block,
+                             buffer_mode mode = buffer_mode::heap,
+                             memory_provider* provider = nullptr);
     ~buddy_allocator() override;
 
-    [[nodiscard]] virtual void* allocate(size_t size, // here alignment is ignored
-                                         [[maybe_unused]] size_t alignment = 0) override;
+    // Requests up to 512 bytes are served from slabs: a 1KB block split into equal objects of
+    // one size class (16, 32, ... 512), aligned to the class size. The block returns to the tree
+    // once its last object is freed. Larger requests get a power-of-two block, whose alignment
+    // relative to the buffer start is its size, an explicit alignment is ignored for them.
+    [[nodiscard]] virtual void* allocate(size_t size, size_t alignment = 0) override;
+    [[nodiscard]] virtual std::expected<void*, alloc_error>
+    try_allocate(size_t size, size_t alignment = 0) noexcept override;
+
+    // the granted size: the power-of-two block, the trimmed extent or the slab object
+    [[nodiscard]] virtual allocation_result<void*> allocate_at_least(size_t size,
+                                                                     size_t alignment = 0) override;
+
+    // Lifetime-hinted placement: the fitting free block that lies lowest (long-lived) or reaches
+    // highest (short-lived) in the buffer is split towards that end, so short-lived churn does
+    // not fragment the region long-lived data sits in. Slab-sized requests ignore the hint.
+    [[nodiscard]] void* allocate(size_t size, lifetime hint);
     virtual void deallocate(void* ptr) override;
+
+    // Sized deallocation: size and alignment as passed to allocate. A slab-sized object finds
+    // its slab by index rather than through the allocation map, other sizes fall back to
+    // deallocate(ptr).
+    virtual void deallocate(void* ptr, size_t size, size_t alignment = 0) override;
+
+    // Allocate count blocks of size at once into out, e.g. the IO buffers of a batch. Each free
+    // block taken is split once into consecutive pieces rather than walked per request. Returns
+    // the number of pointers written, less than count if memory runs out (those stay valid and
+    // are freed with deallocate as usual).
+    [[nodiscard]] size_t allocate_n(size_t size, size_t count, void** out);
+
+    // Resize an allocation, in place when possible: shrinking releases the upper part to the
+    // free lists and growing absorbs the free buddies that follow the block. Otherwise the data
+    // is copied to a new block. Returns nullptr (old block untouched) if no block is available.
+    [[nodiscard]] void* reallocate(void* ptr, size_t newSize);
     virtual size_t getAllocatedSize() const override;
-    virtual size_t getObjectSize() const override { return 0; } // not tracked;
+    virtual size_t getObjectSize() const override {
+        return m_lastAllocation; // granted size of the last allocation
+    }
     virtual void reset() override;
     virtual void setAllocatorName(std::string_view name) override;
     void releaseMemory();
 
-    // disable copy and move
+    // Needs a provider that can purge (mmap mode, an mmap or memfd provider), no-op otherwise.
+    // Free blocks of at least minBlockSize (1MB by default) give their pages back to the OS,
+    // except the first page that holds the free-list header. With onFree a block is released
+    // lazily (MADV_FREE) as soon as it coalesces to that size, otherwise only purge() does it.
+    void setPurgeThreshold(size_t minBlockSize, bool onFree = false);
+    size_t purge(); // MADV_DONTNEED all such free blocks now, returns the bytes released
+    buddy_stats getStats() const;
+
+    // Deferred coalescing: freed blocks are parked in a per-level cache (like the Linux per-CPU
+    // page lists) and handed straight back to same-size requests. A level is merged into the
+    // tree once it caches more than cacheLimit blocks or when a larger request cannot be
+    // served. 0 (the default) merges on every deallocate.
+    void setLazyCoalescing(size_t cacheLimit);
+
+    // Moving hands the buffer over with every live allocation, their pointers stay valid. The
+    // moved-from allocator holds no memory, as after releaseMemory(), until reset(). Adapters
+    // and pmr resources keep referring to the object they were given, not to the memory.
+    buddy_allocator(buddy_allocator&& other) noexcept;
+    buddy_allocator& operator=(buddy_allocator&& other) noexcept;
+    void swap(buddy_allocator& other) noexcept;
+    friend void swap(buddy_allocator& a, buddy_allocator& b) noexcept { a.swap(b); }
+
+    // disable copy
     buddy_allocator(const buddy_allocator&) = delete;
     buddy_allocator& operator=(const buddy_allocator&) = delete;
-    buddy_allocator(buddy_allocator&&) = delete;
-    buddy_allocator& operator=(buddy_allocator&&) = delete;
 
   private:
+    friend class concurrent_buddy_allocator; // shares the level math and buffer bounds
+
     // helper functions
     static int get_level(size_t size);
     static size_t get_power_of_two(size_t size);
     static size_t get_level_size(int level); // size of block at given level
+    size_t get_granted_size(size_t size) const; // extent handed out for a request (policy)
+
+    // how far the pages of a free block were given back, reset whenever it joins a free list
+    enum class purge_state : std::uint8_t {
+        none,    // pages may be resident
+        lazy,    // MADV_FREE, reclaimed only under memory pressure
+        released // gone, purge() has nothing left to release
+    };
 
     struct Buddy {
         Buddy* next_free = nullptr;
-        int level = -1; // level in buddy system
+        Buddy* prev_free = nullptr;
+        purge_state purged = purge_state::none;
+    };
+
+    // a minimum block carved into equal objects of one size class (requests up to 512 bytes),
+    // the free bitmap lives here rather than in the block so every byte is usable
+    struct slab {
+        void* block = nullptr;
+        int sizeClass = 0;          // object size is 16 << sizeClass
+        std::uint64_t freeMask = 0; // bit n set when object n is free
+        size_t used = 0;
+        size_t requested = 0; // sum of requested sizes of the live objects
+        slab* prev = nullptr; // partial slab list of the size class
+        slab* next = nullptr;
+    };
+
+    struct block_info {
+        int level = 0;        // level of the block the allocation was carved from
+        size_t size = 0;      // granted extent, smaller than the level size if the tail was trimmed
+        size_t requested = 0; // size asked for by the caller
+        slab* owner = nullptr; // set when the block is a small-object slab
     };
 
     // freelist for each level
     std::array<Buddy*, 18>
         freeLists{}; // from 1KB to 128MB (level 0 to level 17, which is 2^10 to 2^27)
-    std::unordered_map<void*, int> allocatedBuddies; // map of allocated buddies and their levels
+    std::unordered_map<void*, block_info> allocatedBuddies; // map of allocated buddies
+
+    // small-object slabs, keyed by their block, and the slabs of each class with free objects
+    std::unordered_map<void*, slab> m_slabs;
+    std::array<slab*, 6> partialSlabs{}; // 16, 32, 64, 128, 256, 512 bytes
+    std::vector<slab*> slabIndex;        // slab carved from each minimum block, if any
+
+    // level of the free block starting at each 1KB unit, -1 if no free block starts there.
+    // Kept out of band so merging never reads headers from memory that may belong to the user.
+    std::vector<std::int8_t> freeLevels;
+
+    // address-ordered view of the free lists for hinted placement: bit i of a level is set when
+    // its i-th block is free, summary bit w when word w has a bit set
+    struct free_bitmap {
+        std::vector<std::uint64_t> words;
+        std::vector<std::uint64_t> summary;
+    };
+    std::array<free_bitmap, 18> freeBitmaps;
+    void init_free_bitmaps();
+    void set_free_bit(Buddy* buddy, int level, bool free);
+    Buddy* find_free_block(int level, bool highest) const; // lowest or highest free block
+
+    // freed blocks waiting to be coalesced (lazy mode), linked through next_free
+    std::array<Buddy*, 18> cachedLists{};
+    std::array<size_t, 18> cachedCounts{};
+    size_t m_cacheLimit = 0; // 0 = eager coalescing
+
+    // statistics, updated whenever a block enters or leaves a free list or the allocation map
+    std::array<size_t, 18> freeCounts{};
+    std::uint32_t m_freeMask = 0; // bit n set when freeLists[n] is non-empty
+    size_t m_freeBytes = 0;
+    size_t m_allocatedBytes = 0;
+    size_t m_requestedBytes = 0;
+    size_t m_lastAllocation = 0;
+    void reset_counters();
 
     // freelist helper functions
     void add_to_free_list(Buddy* buddy, int level);
     void remove_from_free_list(Buddy* buddy, int level);
     Buddy* get_first_free_buddy(int level);
     int find_non_empty_level(int startLevel);
+    Buddy* take_free_block(int level); // pop or split a block down to level, nullptr if none
+    Buddy* acquire_block(int level);   // cached block first, flushes the caches if needed
+    Buddy* take_placed_block(int level, bool high); // split towards the low or high end
+    void* allocate_slow(size_t size, size_t alignment); // everything but a partial slab hit
+    std::expected<void*, alloc_error> try_allocate_slow(size_t size, size_t alignment) noexcept;
+    void* record_allocation(Buddy* buddy, size_t size); // trim the tail, enter it in the map
+    void release_block(Buddy* buddy, int level);
+    std::unordered_map<void*, block_info>::iterator find_allocation(void* ptr);
+
+    // small-object slab helpers
+    static int get_slab_class(size_t size, size_t alignment);
+    static size_t get_slab_object_size(int sizeClass);
+    void* allocate_small(size_t size, size_t alignment);
+    slab* get_partial_slab(int sizeClass); // nullptr when no minimum block is left
+    void* take_slab_object(slab* s, size_t size);
+    void free_small(slab* s, void* ptr);
+    void push_partial_slab(slab* s);
+    void remove_partial_slab(slab* s);
+
+    // lazy coalescing helpers
+    Buddy* take_cached_block(int level);
+    void cache_block(Buddy* buddy, int level);
+    void flush_cached_level(int level);
+    void flush_cached_blocks();
 
     // buddy helper functions
     Buddy* split_buddy(Buddy* b, int level);
     void try_merge_buddies(Buddy* buddy, int level);
     Buddy* find_buddy(Buddy* b, int level);
+    bool is_free_at_level(Buddy* b, int level) const;
+    void release_range(uintptr_t begin, uintptr_t end, bool merge); // free [begin, end) offsets
+    size_t purge_block(Buddy* buddy, int level, bool immediate);  // purge all but the header
+    bool try_grow_in_place(uintptr_t offset, size_t oldSize, size_t newSize);
 
     // Pre-allocated memory buffer
     struct buffer {
-        std::unique_ptr<std::byte[]> memory; // Contiguous memory
-        size_t size = 0;                     // Total buffer size
-        void* start_address = nullptr;       // Starting address of the buffer
-        int initial_level = 0;               // Initial level of the buffer
+        provider_ptr memory;           // Contiguous memory
+        size_t size = 0;               // Total buffer size
+        void* start_address = nullptr; // Starting address of the buffer
+        int initial_level = 0;         // Level of the largest root block
         uintptr_t start_address_int = 0;
     } m_buffer;
 
     void allocate_new_buffer();
+    void add_root_blocks(); // seed the free lists with the power-of-two roots of the buffer
     size_t m_buffersize;
+    split_policy m_policy;
+    memory_provider* m_provider; // not owned
+    int m_purgeLevel = 10;      // smallest level purged, 1MB
+    bool m_purgeOnFree = false; // release coalesced blocks right away
     bool m_ownsMemory = false;
     static constexpr size_t MIN_CAPACITY = 1024;                 // 1KB
+    static constexpr size_t MIN_SLAB_OBJECT = 16;                // smallest slab size class
+    static constexpr size_t MAX_SLAB_OBJECT = MIN_CAPACITY / 2;  // larger requests get a block
     static constexpr size_t MAX_CAPACITY = 128ull * 1024 * 1024; // 128 MB
     std::string m_allocator = "buddy_allocator";                 // Custom Name for debugging
 };
+
+// fast path: a small request whose size class has a partial slab takes its lowest free object
+inline void* buddy_allocator::allocate(size_t size, size_t alignment) {
+    if (std::max(size, alignment) <= MAX_SLAB_OBJECT) {
+        if (slab* s = partialSlabs[get_slab_class(size, alignment)]) {
+            return take_slab_object(s, size);
+        }
+    }
+    return allocate_slow(size, alignment);
+}
+
+inline std::expected<void*, alloc_error> buddy_allocator::try_allocate(size_t size,
+                                                                      size_t alignment) noexcept {
+    if (std::max(size, alignment) <= MAX_SLAB_OBJECT) {
+        if (slab* s = partialSlabs[get_slab_class(size, alignment)]) {
+            return take_slab_object(s, size);
+        }
+    }
+    return try_allocate_slow(size, alignment);
+}
+
+inline int buddy_allocator::get_slab_class(size_t size, size_t alignment) {
+    // 16, 32, ... 512 bytes, objects are aligned to their class size
+    size_t objectSize = std::bit_ceil(std::max({size, alignment, MIN_SLAB_OBJECT}));
+    return std::countr_zero(objectSize) - std::countr_zero(MIN_SLAB_OBJECT);
+}
+
+inline size_t buddy_allocator::get_slab_object_size(int sizeClass) {
+    return MIN_SLAB_OBJECT << sizeClass;
+}
+
+inline void* buddy_allocator::take_slab_object(slab* s, size_t size) {
+    size_t objectSize = get_slab_object_size(s->sizeClass);
+
+    // lowest free object of the slab
+    int index = std::countr_zero(s->freeMask);
+    s->freeMask &= s->freeMask - 1;
+    ++s->used;
+    s->requested += size;
+    if (s->freeMask == 0) {
+        remove_partial_slab(s); // full, no longer a candidate
+    }
+
+    m_allocatedBytes += objectSize;
+    m_requestedBytes += size;
+    m_lastAllocation = objectSize;
+    return static_cast<std::byte*>(s->block) + index * objectSize;
+}
 } // namespace allocator
 
 #endif // BUDDY_ALLOCATOR_HPP
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef CONCURRENT_BUDDY_ALLOCATOR_HPP
+#define CONCURRENT_BUDDY_ALLOCATOR_HPP
+
+#include "allocator/buddy_allocator.hpp"
+#include <atomic>
+#include <mutex>
+
+namespace allocator {
+
+// Thread-safe buddy allocator. Blocks of the lowest levels (1KB to 64KB) are served from
+// per-CPU caches, each behind its own lock, so threads on different CPUs rarely touch the
+// shared tree. Caches refill from and drain to a single locked buddy_allocator in batches,
+// larger requests go to that tree directly.
+class concurrent_buddy_allocator : public AllocatorInterface {
+  public:
+    // shardCount = 0 uses one cache per hardware thread, the buffer comes from provider
+    explicit concurrent_buddy_allocator(size_t bufferSize, size_t shardCount = 0,
+                                        memory_provider* provider = nullptr);
+    ~concurrent_buddy_allocator() override;
+
+    [[nodiscard]] virtual void* allocate(size_t size, // here alignment is ignored
+                                         [[maybe_unused]] size_t alignment = 0) override;
+    [[nodiscard]] virtual std::expected<void*, alloc_error>
+    try_allocate(size_t size, [[maybe_unused]] size_t alignment = 0) noexcept override;
+    virtual void deallocate(void* ptr) override;
+    using AllocatorInterface::deallocate; // sized overload, the size is not needed
+    virtual size_t getAllocatedSize() const override;
+    virtual size_t getObjectSize() const override { return 0; } // not tracked;
+    virtual void reset() override;
+    virtual void setAllocatorName(std::string_view name) override;
+    void releaseMemory();
+
+    // disable copy and move
+    concurrent_buddy_allocator(const concurrent_buddy_allocator&) = delete;
+    concurrent_buddy_allocator& operator=(const concurrent_buddy_allocator&) = delete;
+    concurrent_buddy_allocator(concurrent_buddy_allocator&&) = delete;
+    concurrent_buddy_allocator& operator=(concurrent_buddy_allocator&&) = delete;
+
+  private:
+    static constexpr int CACHED_LEVELS = 7;      // 1KB .. 64KB
+    static constexpr size_t BATCH_SIZE = 8;      // blocks moved per refill / drain
+    static constexpr size_t HIGH_WATERMARK = 32; // drain a level once it caches this many
+
+    // state of a cached-level block, one byte per 1KB unit of the buffer
+    static constexpr std::uint8_t IN_CACHE = 0x80; // block sits in a shard cache (free)
+
+    struct alignas(64) shard {
+        std::mutex lock;
+        std::array<std::vector<void*>, CACHED_LEVELS> blocks;
+    };
+
+    shard& current_shard();
+    bool refill(shard& s, int level);              // called with s.lock held
+    void drain(shard& s, int level, size_t count); // called with s.lock held
+    void drain_all_shards();
+    std::uint8_t& block_state(void* ptr);
+
+    buddy_allocator m_global; // shared tree, guarded by m_globalLock
+    std::mutex m_globalLock;
+    std::unique_ptr<shard[]> m_shards;
+    size_t m_shardCount;
+    std::unique_ptr<std::uint8_t[]> m_blockStates; // level + 1 of blocks handed out by a cache
+    std::atomic<size_t> m_allocatedSize{0};
+    std::string m_allocator = "concurrent_buddy_allocator"; // Custom Name for debugging
+};
+
+} // namespace allocator
+
+#endif // CONCURRENT_BUDDY_ALLOCATOR_HPP
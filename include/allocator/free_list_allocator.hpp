@@ -0,0 +1,97 @@
+#ifndef FREE_LIST_ALLOCATOR_HPP
+#define FREE_LIST_ALLOCATOR_HPP
+
+#include "allocator/allocator_interface.hpp"
+#include "allocator/memory_provider.hpp"
+#include <cstdint>
+
+namespace allocator {
+
+// Variable-size allocator with boundary tags (Knuth): every block carries its size in a header
+// and a matching footer, so a freed block finds both physical neighbours in O(1) and merges
+// with the free ones immediately. Free blocks are kept on an explicit doubly linked list that
+// is searched with the policy chosen at construction. Blocks are only rounded to 16 bytes,
+// which suits odd-sized, medium-lived objects freed in any order.
+class free_list_allocator : public AllocatorInterface {
+  public:
+    enum class fit_policy {
+        first_fit, // first block large enough, from the head of the list
+        next_fit,  // like first_fit, resuming where the previous search stopped
+        best_fit   // smallest block large enough, stops early on an exact fit
+    };
+
+    // the buffer comes from provider, operator new when null
+    explicit free_list_allocator(size_t bufferSize, fit_policy policy = fit_policy::best_fit,
+                                 memory_provider* provider = nullptr);
+    ~free_list_allocator() override;
+
+    // alignment 0 means 16 bytes, larger powers of two split off a leading free block
+    [[nodiscard]] virtual void* allocate(size_t size, size_t alignment = 0) override;
+    [[nodiscard]] virtual std::expected<void*, alloc_error>
+    try_allocate(size_t size, size_t alignment = 0) noexcept override;
+    virtual void deallocate(void* ptr) override;
+    using AllocatorInterface::deallocate; // sized overload, the size is not needed
+    virtual size_t getAllocatedSize() const override;
+    virtual size_t getObjectSize() const override; // usable size of the last allocation
+    virtual void reset() override;
+    virtual void setAllocatorName(std::string_view name) override;
+    void releaseMemory();
+
+    size_t getFreeBlockCount() const;
+
+    // disable copy and move
+    free_list_allocator(const free_list_allocator&) = delete;
+    free_list_allocator& operator=(const free_list_allocator&) = delete;
+    free_list_allocator(free_list_allocator&&) = delete;
+    free_list_allocator& operator=(free_list_allocator&&) = delete;
+
+  private:
+    // header and footer hold the block size (tags included) with ALLOCATED in the low bit.
+    // The payload of a free block holds its list links.
+    struct free_links {
+        std::byte* next;
+        std::byte* prev;
+    };
+
+    static constexpr size_t ALLOCATED = 1;
+    static constexpr size_t TAG_SIZE = sizeof(size_t);
+    static constexpr size_t BLOCK_ALIGNMENT = 16;
+    static constexpr size_t MIN_BLOCK_SIZE = 2 * TAG_SIZE + sizeof(free_links); // 32 bytes
+    static constexpr size_t MIN_CAPACITY = 1024;                                 // 1KB
+    static constexpr size_t MAX_CAPACITY = 128ull * 1024 * 1024;                 // 128 MB
+
+    // boundary tag helpers, a block is addressed by its header
+    static size_t& header(std::byte* block);
+    static size_t& footer(std::byte* block);
+    static size_t block_size(std::byte* block);
+    static bool is_allocated(std::byte* block);
+    static void write_tags(std::byte* block, size_t size, bool allocated);
+    static free_links& links(std::byte* block);
+
+    void insert_free_block(std::byte* block);
+    void remove_free_block(std::byte* block);
+
+    // bytes to skip at the start of block so the payload is aligned, or npos if size won't fit
+    static size_t fit_offset(std::byte* block, size_t size, size_t alignment);
+    std::byte* find_free_block(size_t size, size_t alignment, size_t& offset);
+
+    void allocate_new_buffer();
+    void init_free_list();
+
+    provider_ptr m_memory;
+    size_t m_bufferSize;
+    fit_policy m_policy;
+    bool m_ownsMemory = false;
+    memory_provider* m_provider; // not owned
+
+    std::byte* m_freeHead = nullptr;
+    std::byte* m_rover = nullptr; // next-fit resume point
+    size_t m_freeBlockCount = 0;
+    size_t m_allocatedSize = 0;
+    size_t m_lastAllocation = 0;
+    std::string m_allocator = "free_list_allocator"; // Custom Name for debugging
+};
+
+} // namespace allocator
+
+#endif // FREE_LIST_ALLOCATOR_HPP
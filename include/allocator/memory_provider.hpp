@@ -0,0 +1,144 @@
+#ifndef MEMORY_PROVIDER_HPP
+#define MEMORY_PROVIDER_HPP
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace allocator {
+
+class AllocatorInterface;
+
+// Where an allocator gets its backing memory: the buffers, pools and slabs it carves up. The
+// allocators take a provider at construction and go through it for every such range, so the
+// OS-level choices (huge pages, shared memory, a static arena) are made in one place. A provider
+// is not owned by the allocators using it and must outlive them.
+class memory_provider {
+  public:
+    virtual ~memory_provider() = default;
+
+    // size bytes aligned to alignment (a power of two), nullptr when none can be had. The
+    // contents are unspecified.
+    [[nodiscard]] virtual void* acquire(size_t size, size_t alignment) noexcept = 0;
+
+    // gives back a range from acquire, with the size and alignment it was acquired with
+    virtual void release(void* ptr, size_t size, size_t alignment) noexcept = 0;
+
+    // Hands the physical pages of [ptr, ptr + size), a page aligned part of an acquired range,
+    // back to the OS while the range stays usable. lazy lets the kernel wait for memory pressure.
+    // Returns the bytes released, 0 when the provider cannot do it.
+    virtual size_t purge([[maybe_unused]] void* ptr, [[maybe_unused]] size_t size,
+                         [[maybe_unused]] bool lazy) noexcept {
+        return 0;
+    }
+
+    static size_t page_size() noexcept;
+};
+
+// operator new and delete, the default. Ranges are left uninitialized, so a large buffer
+// (which malloc maps from the OS) only takes physical pages as they are first written.
+class new_delete_provider final : public memory_provider {
+  public:
+    [[nodiscard]] void* acquire(size_t size, size_t alignment) noexcept override;
+    void release(void* ptr, size_t size, size_t alignment) noexcept override;
+};
+
+// Anonymous private mappings. Pages are only backed once touched, and purge() returns them.
+// With huge pages, ranges are rounded to 2MB and mapped with MAP_HUGETLB when the system has
+// huge pages reserved, otherwise transparent huge pages are requested for them.
+class mmap_provider final : public memory_provider {
+  public:
+    enum class pages {
+        normal, // the system page size
+        huge    // 2MB pages, fewer TLB misses for large buffers
+    };
+
+    explicit mmap_provider(pages kind = pages::normal) : m_pages(kind) {}
+
+    [[nodiscard]] void* acquire(size_t size, size_t alignment) noexcept override;
+    void release(void* ptr, size_t size, size_t alignment) noexcept override;
+    size_t purge(void* ptr, size_t size, bool lazy) noexcept override;
+
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+  private:
+    size_t mapped_size(size_t size) const noexcept;
+    pages m_pages;
+};
+
+// Shared mappings of anonymous files (Linux memfd_create), one file per range. The descriptor
+// of a range can be passed to another process, which maps the same memory. Nothing is
+// available on other systems.
+class memfd_provider final : public memory_provider {
+  public:
+    explicit memfd_provider(std::string name = "allocator") : m_name(std::move(name)) {}
+    ~memfd_provider() override;
+
+    [[nodiscard]] void* acquire(size_t size, size_t alignment) noexcept override;
+    void release(void* ptr, size_t size, size_t alignment) noexcept override;
+    size_t purge(void* ptr, size_t size, bool lazy) noexcept override;
+
+    int getFileDescriptor(void* ptr) const; // of a range from acquire, -1 if unknown
+
+  private:
+    std::string m_name;
+    mutable std::mutex m_lock;
+    std::unordered_map<void*, int> m_files; // descriptor of each live range
+};
+
+// A caller-supplied buffer, handed out front to back. Only the most recent range goes back to
+// the buffer when released, the others come back when the buffer is reset. Not thread-safe.
+class buffer_provider final : public memory_provider {
+  public:
+    buffer_provider(void* buffer, size_t size);
+
+    [[nodiscard]] void* acquire(size_t size, size_t alignment) noexcept override;
+    void release(void* ptr, size_t size, size_t alignment) noexcept override;
+
+    void reset() { m_used = 0; } // every range is free again
+    size_t getUsedSize() const { return m_used; }
+
+  private:
+    std::byte* m_buffer;
+    size_t m_size;
+    size_t m_used = 0;
+};
+
+// Another allocator's memory, e.g. pools carved out of a buddy allocator's buffer
+class upstream_provider final : public memory_provider {
+  public:
+    explicit upstream_provider(AllocatorInterface& upstream) : m_upstream(upstream) {}
+
+    [[nodiscard]] void* acquire(size_t size, size_t alignment) noexcept override;
+    void release(void* ptr, size_t size, size_t alignment) noexcept override;
+
+  private:
+    AllocatorInterface& m_upstream;
+};
+
+// the provider used when an allocator is given none, a new_delete_provider
+memory_provider* default_memory_provider() noexcept;
+
+// Owning pointer to a range from a provider, released through it
+struct provider_deleter {
+    memory_provider* provider = nullptr;
+    size_t size = 0;
+    size_t alignment = 0;
+
+    void operator()(std::byte* ptr) const noexcept { provider->release(ptr, size, alignment); }
+};
+
+using provider_ptr = std::unique_ptr<std::byte[], provider_deleter>;
+
+// empty when the provider has nothing to give
+inline provider_ptr acquire_buffer(memory_provider& provider, size_t size,
+                                   size_t alignment) noexcept {
+    auto* ptr = static_cast<std::byte*>(provider.acquire(size, alignment));
+    return provider_ptr(ptr, provider_deleter{&provider, size, alignment});
+}
+
+} // namespace allocator
+
+#endif // MEMORY_PROVIDER_HPP
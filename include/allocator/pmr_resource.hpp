@@ -0,0 +1,79 @@
+#ifndef PMR_RESOURCE_HPP
+#define PMR_RESOURCE_HPP
+
+#include "allocator/allocator_interface.hpp"
+#include "allocator/stack_allocator.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <memory_resource>
+#include <type_traits>
+#include <unordered_set>
+
+namespace allocator {
+
+// Exposes one of the allocators as a std::pmr::memory_resource, so std::pmr containers use it
+// without a change of type. Requests the allocator cannot serve (exhausted, larger than a pool
+// block, or not aligned as asked) go to the upstream resource and are given back to it when
+// freed. A stack_allocator ignores deallocation like std::pmr::monotonic_buffer_resource, since
+// containers free in any order: its memory comes back with reset() or reset_to_mark().
+template <Allocator Alloc> class pmr_resource : public std::pmr::memory_resource {
+  public:
+    explicit pmr_resource(Alloc& alloc,
+                          std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : m_alloc(alloc), m_upstream(upstream) {}
+
+    Alloc& getAllocator() const { return m_alloc; }
+    std::pmr::memory_resource* upstream_resource() const { return m_upstream; }
+    size_t getUpstreamCount() const { return m_upstreamBlocks.size(); } // live fallbacks
+
+  protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        auto result = m_alloc.try_allocate(bytes, native_alignment(alignment));
+        void* ptr = result ? *result : nullptr;
+
+        // pool blocks and stack chunks follow their own alignment, not the one asked for
+        if (ptr && reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0) {
+            return ptr;
+        }
+        if (ptr) {
+            release(ptr, bytes, alignment);
+        }
+
+        ptr = m_upstream->allocate(bytes, alignment);
+        m_upstreamBlocks.insert(ptr);
+        return ptr;
+    }
+
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+        if (!m_upstreamBlocks.empty() && m_upstreamBlocks.erase(ptr)) {
+            m_upstream->deallocate(ptr, bytes, alignment);
+            return;
+        }
+        release(ptr, bytes, alignment);
+    }
+
+    // the record of upstream blocks is per resource, only the same object can free its memory
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+  private:
+    // containers ask for byte alignment, the allocators work with at least word alignment
+    static size_t native_alignment(size_t alignment) {
+        return std::max(alignment, alignof(void*));
+    }
+
+    void release(void* ptr, size_t bytes, size_t alignment) {
+        if constexpr (!std::is_same_v<Alloc, stack_allocator>) {
+            m_alloc.deallocate(ptr, bytes, native_alignment(alignment));
+        }
+    }
+
+    Alloc& m_alloc;
+    std::pmr::memory_resource* m_upstream;
+    std::unordered_set<void*> m_upstreamBlocks; // served by the upstream resource
+};
+
+} // namespace allocator
+
+#endif // PMR_RESOURCE_HPP
@@ -2,53 +2,152 @@
 #define POOL_ALLOCATOR_HPP
 
 #include "allocator/allocator_interface.hpp"
+#include "allocator/memory_provider.hpp"
+#include <cstdint>
 #include <vector>
 
 namespace allocator {
-class pool_allocator : public AllocatorInterface {
+class pool_allocator final : public allocator_base<pool_allocator> {
   public:
+    // pools come from provider, operator new when null
     explicit pool_allocator(size_t blockSize, size_t blockCount, size_t alignment = 0,
-                            size_t maxPools = 0);
+                            size_t maxPools = 0, memory_provider* provider = nullptr);
     ~pool_allocator() override;
 
     [[nodiscard]] virtual void* allocate(size_t size,
                                          [[maybe_unused]] size_t alignment = 0) override;
     [[nodiscard]] void* allocate();
-    virtual void deallocate(void* ptr) override;
+    [[nodiscard]] virtual std::expected<void*, alloc_error>
+    try_allocate(size_t size, [[maybe_unused]] size_t alignment = 0) noexcept override;
+    virtual void deallocate(void* ptr) override; // checks as default_check_policy
+    template <check_policy Policy> void deallocate(void* ptr);
+    using AllocatorInterface::deallocate; // sized overload, the size is not needed
     virtual size_t getAllocatedSize() const override;
     virtual size_t getObjectSize() const override;
     virtual void reset() override;
     virtual void setAllocatorName(std::string_view name) override;
     void releaseMemory();
 
-    // disable copy and move
+    // Moving hands the pools over with every live block, their pointers stay valid. The
+    // moved-from allocator holds no memory, as after releaseMemory(), until reset().
+    pool_allocator(pool_allocator&& other) noexcept;
+    pool_allocator& operator=(pool_allocator&& other) noexcept;
+    void swap(pool_allocator& other) noexcept;
+    friend void swap(pool_allocator& a, pool_allocator& b) noexcept { a.swap(b); }
+
+    // disable copy
     pool_allocator(const pool_allocator&) = delete;
     pool_allocator& operator=(const pool_allocator&) = delete;
-    pool_allocator(pool_allocator&&) = delete;
-    pool_allocator& operator=(pool_allocator&&) = delete;
 
   private:
+    // out of line: the current pool is exhausted or the request is invalid
+    [[nodiscard]] void* allocate_slow(size_t size);
+    [[nodiscard]] std::expected<void*, alloc_error> try_allocate_slow(size_t size) noexcept;
+    template <check_policy Policy> void deallocate_slow(void* ptr);
+    void* pop_current() noexcept; // nullptr when the current pool is empty
+
+    // Blocks past carved were never handed out and are not on the free list. They are taken
+    // in address order once the free list runs dry, so a new pool touches no memory until its
+    // blocks are used.
     struct pool {
-        std::unique_ptr<std::byte[]> memory;
+        provider_ptr memory;
         size_t size = 0;
         void* free_list_head = nullptr;
+        size_t carved = 0; // bytes handed out at least once
         size_t allocated_count = 0;
         size_t free_count = 0;
+
+        bool has_free_block() const { return free_list_head || carved < size; }
     };
 
-    void allocate_new_pool();
+    void allocate_new_pool();                             // throws when the pool cannot grow
+    std::expected<void, alloc_error> add_pool() noexcept; // the non-throwing version
 
     size_t m_blockSize;
     size_t m_blockCount;
     size_t m_alignment;
     size_t m_poolSize;
     std::vector<pool> pools;
+    size_t m_currentPool = 0;  // pool that served the last allocation, tried first
     bool m_ownsMemory = false; // check if the allocator owns the memory
     size_t m_maxPools = 0;     // configurable
+    memory_provider* m_provider; // not owned
     static constexpr size_t MAX_CAPACITY = 64ull * 1024 * 1024; // 64 MB hard cap
     std::string m_allocator = "pool_allocator";
 };
 
+// This function exists solely to support polymorphism.
+// The actual memory allocation is handled by allocate() without arguments,
+// which simply returns a free block.
+inline void* pool_allocator::allocate(size_t size, [[maybe_unused]] size_t alignment) {
+    if (size > m_blockSize) [[unlikely]] {
+        return allocate_slow(size);
+    }
+    return allocate();
+}
+
+inline void* pool_allocator::allocate() {
+    if (void* block = pop_current()) {
+        return block;
+    }
+    return allocate_slow(m_blockSize);
+}
+
+inline std::expected<void*, alloc_error>
+pool_allocator::try_allocate(size_t size, [[maybe_unused]] size_t alignment) noexcept {
+    if (size <= m_blockSize) {
+        if (void* block = pop_current()) {
+            return block;
+        }
+    }
+    return try_allocate_slow(size);
+}
+
+// fast path: pop the free list of the current pool, or carve its next untouched block
+inline void* pool_allocator::pop_current() noexcept {
+    if (m_currentPool < pools.size()) {
+        pool& p = pools[m_currentPool];
+        void* block = p.free_list_head;
+        if (block) {
+            p.free_list_head = *reinterpret_cast<void**>(block);
+        } else if (p.carved < p.size) {
+            block = p.memory.get() + p.carved;
+            p.carved += m_blockSize;
+        } else {
+            return nullptr;
+        }
+        p.allocated_count++;
+        p.free_count--;
+        return block;
+    }
+    return nullptr;
+}
+
+inline void pool_allocator::deallocate(void* ptr) {
+    deallocate<default_check_policy>(ptr);
+}
+
+// fast path: a block of the current pool goes straight back on its free list. Paranoid frees
+// always go out of line to walk the free list for a double free.
+template <check_policy Policy> inline void pool_allocator::deallocate(void* ptr) {
+    if constexpr (Policy != check_policy::paranoid) {
+        if (m_currentPool < pools.size()) {
+            pool& p = pools[m_currentPool];
+            auto start = reinterpret_cast<std::uintptr_t>(p.memory.get());
+            std::uintptr_t offset = reinterpret_cast<std::uintptr_t>(ptr) - start;
+            bool onGrid = Policy == check_policy::unchecked || offset % m_blockSize == 0;
+            if (offset < p.size && onGrid) {
+                *reinterpret_cast<void**>(ptr) = p.free_list_head;
+                p.free_list_head = ptr;
+                --p.allocated_count;
+                ++p.free_count;
+                return;
+            }
+        }
+    }
+    deallocate_slow<Policy>(ptr);
+}
+
 } // namespace allocator
 
 #endif // POOL_ALLOCATOR_HPP
\ No newline at end of file
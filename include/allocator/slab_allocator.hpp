@@ -0,0 +1,112 @@
+#ifndef SLAB_ALLOCATOR_HPP
+#define SLAB_ALLOCATOR_HPP
+
+#include "allocator/allocator_interface.hpp"
+#include "allocator/memory_provider.hpp"
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+
+namespace allocator {
+
+// Object-caching slab allocator (Bonwick). Objects of one type are carved from slabs, each a
+// pool of equal slots with its own free list like pool_allocator. The constructor runs once per
+// slot when its slab is created and the destructor only when the slab is reclaimed, so freed
+// objects keep their constructed state and the next allocate hands them out ready to use.
+// Callers must give objects back in that constructed state.
+//
+// Slabs sit on full, partial and empty lists. Allocation takes from partial slabs first, so
+// live objects stay packed in few slabs. Empty slabs are kept for reuse until reap() reclaims
+// them, or right away once there are more than maxEmptySlabs.
+class slab_allocator : public AllocatorInterface {
+  public:
+    using object_callback = std::function<void(void*)>;
+    static constexpr size_t KEEP_ALL_EMPTY = std::numeric_limits<size_t>::max();
+
+    // Slabs come from provider, operator new when null. constructor runs on every slot of a new
+    // slab and destructor on every slot of a reclaimed one, destructor must not throw. When
+    // constructor throws, the slab is undone and the exception propagates out of allocate(),
+    // while try_allocate() reports it as out_of_memory.
+    explicit slab_allocator(size_t objectSize, size_t alignment = 0,
+                            object_callback constructor = {}, object_callback destructor = {},
+                            size_t maxEmptySlabs = KEEP_ALL_EMPTY,
+                            memory_provider* provider = nullptr);
+    ~slab_allocator() override;
+
+    [[nodiscard]] virtual void* allocate(size_t size, size_t alignment = 0) override;
+    [[nodiscard]] void* allocate();
+    [[nodiscard]] virtual std::expected<void*, alloc_error>
+    try_allocate(size_t size, size_t alignment = 0) noexcept override;
+    [[nodiscard]] std::expected<void*, alloc_error> try_allocate() noexcept;
+    virtual void deallocate(void* ptr) override;
+    using AllocatorInterface::deallocate; // sized overload, the size is not needed
+    virtual size_t getAllocatedSize() const override;
+    virtual size_t getObjectSize() const override;
+    virtual void reset() override; // every object is free again, slabs are kept
+    virtual void setAllocatorName(std::string_view name) override;
+    void releaseMemory(); // destroys every object and frees every slab
+
+    size_t reap(); // reclaim all empty slabs, returns how many were freed
+    size_t getSlabCount() const;
+    size_t getObjectsPerSlab() const;
+
+    // disable copy and move
+    slab_allocator(const slab_allocator&) = delete;
+    slab_allocator& operator=(const slab_allocator&) = delete;
+    slab_allocator(slab_allocator&&) = delete;
+    slab_allocator& operator=(slab_allocator&&) = delete;
+
+  private:
+    enum class slab_state { full, partial, empty };
+
+    // A slot is the object followed by a link word. The link threads the free list like in
+    // pool_allocator but outside the object, so its constructed state survives being free.
+    // While the object is allocated the link holds the slab address, which catches double frees.
+    struct slab {
+        std::byte* memory = nullptr;    // aligned to the slab size
+        void* free_list_head = nullptr; // first free slot
+        size_t allocated_count = 0;
+        slab_state state = slab_state::empty;
+        slab* prev = nullptr; // neighbours on the list of its state
+        slab* next = nullptr;
+    };
+
+    struct slab_list {
+        slab* head = nullptr;
+        size_t count = 0;
+    };
+
+    void** link_of(void* object) const; // link word of a slot
+    // allocate without the noexcept wrapper, the constructor of a new slab may throw
+    std::expected<void*, alloc_error> take_object(size_t size, size_t alignment);
+    slab* create_slab(); // nullptr when out of memory, a throwing constructor propagates
+    void destroy_slab(slab* s);
+    void destroy_objects(std::byte* memory, size_t first); // destructor of slots first..end
+    void move_to(slab* s, slab_state state);
+    slab_list& list_of(slab_state state);
+
+    size_t m_objectSize;     // object size rounded to the alignment
+    size_t m_alignment;
+    size_t m_slotSize;       // object + link word, rounded to the alignment
+    size_t m_slabSize;       // power of two, slabs are aligned to it
+    size_t m_objectsPerSlab;
+    size_t m_maxEmptySlabs;
+    memory_provider* m_provider; // not owned
+    object_callback m_constructor;
+    object_callback m_destructor;
+
+    std::unordered_map<std::uintptr_t, slab> m_slabs; // keyed by slab address
+    slab_list m_full;
+    slab_list m_partial;
+    slab_list m_empty;
+    size_t m_allocatedCount = 0;
+
+    static constexpr size_t MIN_SLAB_SIZE = 4096;               // one page
+    static constexpr size_t MAX_CAPACITY = 64ull * 1024 * 1024; // 64 MB hard cap, like the pool
+    std::string m_allocator = "slab_allocator";                 // Custom Name for debugging
+};
+
+} // namespace allocator
+
+#endif // SLAB_ALLOCATOR_HPP
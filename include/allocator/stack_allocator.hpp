@@ -1,15 +1,25 @@
+#ifndef STACK_ALLOCATOR_HPP
+#define STACK_ALLOCATOR_HPP
+
 #include "allocator/allocator_interface.hpp"
+#include "allocator/memory_provider.hpp"
 #include <vector>
 
 namespace allocator {
 
-class stack_allocator : public AllocatorInterface {
+class stack_allocator final : public allocator_base<stack_allocator> {
   public:
-    stack_allocator(size_t bufferSize, size_t alignment = 0, bool m_resizable = false);
+    // buffers come from provider, operator new when null
+    stack_allocator(size_t bufferSize, size_t alignment = 0, bool m_resizable = false,
+                    memory_provider* provider = nullptr);
     ~stack_allocator() override;
 
     [[nodiscard]] virtual void* allocate(size_t size, size_t alignment = 0) override;
-    virtual void deallocate(void* ptr) override;
+    [[nodiscard]] virtual std::expected<void*, alloc_error>
+    try_allocate(size_t size, size_t alignment = 0) noexcept override;
+    virtual void deallocate(void* ptr) override; // checks as default_check_policy
+    template <check_policy Policy> void deallocate(void* ptr);
+    using AllocatorInterface::deallocate; // sized overload, the size is not needed
     virtual size_t getAllocatedSize() const override;
     virtual size_t getObjectSize() const override;
     virtual void reset() override;
@@ -18,16 +28,29 @@ class stack_allocator : public AllocatorInterface {
     const std::pair<size_t, size_t> mark();
     void reset_to_mark(const std::pair<size_t, size_t>& mark);
 
-    // disable copy and move
+    // Moving hands the buffers over with every live allocation and their marks, pointers stay
+    // valid. The moved-from allocator holds no memory, as after releaseMemory(), until reset().
+    stack_allocator(stack_allocator&& other) noexcept;
+    stack_allocator& operator=(stack_allocator&& other) noexcept;
+    void swap(stack_allocator& other) noexcept;
+    friend void swap(stack_allocator& a, stack_allocator& b) noexcept { a.swap(b); }
+
+    // disable copy
     stack_allocator(const stack_allocator&) = delete;
     stack_allocator& operator=(const stack_allocator&) = delete;
-    stack_allocator(stack_allocator&&) = delete;
-    stack_allocator& operator=(stack_allocator&&) = delete;
 
   private:
-    void allocate_new_buffer();
+    // out of line: a new buffer is needed, the alignment differs or the call is invalid
+    [[nodiscard]] void* allocate_slow(size_t size, size_t alignment);
+    [[nodiscard]] std::expected<void*, alloc_error> try_allocate_slow(size_t size,
+                                                                      size_t alignment) noexcept;
+    template <check_policy Policy> void deallocate_slow(void* ptr);
+    void* bump(size_t alignSize) noexcept; // nullptr when the top buffer has no room
+    void drop_to(std::byte* ptr) noexcept; // the top falls back to ptr, inside the top buffer
+    void allocate_new_buffer();                             // throws when no buffer can be added
+    std::expected<void, alloc_error> add_buffer() noexcept; // the non-throwing version
 
-#if ALLOCATOR_DEBUG
+#if ALLOCATOR_DEBUG || ALLOCATOR_PARANOID
     // To track last allocation for deallocation
     struct allocation_info {
         void* ptr;   // Pointer to allocated memory
@@ -35,13 +58,14 @@ class stack_allocator : public AllocatorInterface {
     };
 
     std::vector<allocation_info> allocation_history; // Track allocations for LIFO deallocation
+    void trim_history() noexcept; // forget the allocations above the top
 #endif
 
     // Pre-allocated memory buffer
     struct buffer {
-        std::unique_ptr<std::byte[]> memory; // Contiguous memory
-        size_t size;                         // Total buffer size
-        size_t offset = 0;                   // Current allocation offset
+        provider_ptr memory; // Contiguous memory
+        size_t size;         // Total buffer size
+        size_t offset = 0;   // Current allocation offset
     };
 
     size_t m_alignment;  // Default alignment
@@ -50,9 +74,105 @@ class stack_allocator : public AllocatorInterface {
     std::vector<buffer> buffers; // All allocated buffers
     bool m_resizable = false;    // configurable
     bool m_ownsMemory = false;   // check if the allocator owns the memory
+    memory_provider* m_provider; // not owned
     static constexpr size_t MAX_CAPACITY =
         64ull * 1024 * 1024;                     // 64 MB Max capacity if it's not resizable
     std::string m_allocator = "stack_allocator"; // Custom Name for debugging
 };
 
-} // namespace allocator
\ No newline at end of file
+// fast path: default alignment and room left in the top buffer, a bump of its offset
+inline void* stack_allocator::allocate(size_t size, size_t alignment) {
+    if (alignment == 0 || alignment == m_alignment) {
+        auto alignSize = getAlignedSize(size, m_alignment);
+        if (size <= alignSize) {
+            if (void* ptr = bump(alignSize)) {
+                return ptr;
+            }
+        }
+    }
+    return allocate_slow(size, alignment);
+}
+
+inline std::expected<void*, alloc_error> stack_allocator::try_allocate(size_t size,
+                                                                      size_t alignment) noexcept {
+    if (alignment == 0 || alignment == m_alignment) {
+        auto alignSize = getAlignedSize(size, m_alignment);
+        if (size <= alignSize) {
+            if (void* ptr = bump(alignSize)) {
+                return ptr;
+            }
+        }
+    }
+    return try_allocate_slow(size, alignment);
+}
+
+inline void* stack_allocator::bump(size_t alignSize) noexcept {
+    if (buffers.empty()) {
+        return nullptr;
+    }
+
+    auto& lastbuffer = buffers.back();
+    if (alignSize > lastbuffer.size - lastbuffer.offset) {
+        return nullptr;
+    }
+
+    void* ptr = lastbuffer.memory.get() + lastbuffer.offset;
+    lastbuffer.offset += alignSize;
+    m_lastallocation = alignSize;
+
+#if ALLOCATOR_DEBUG || ALLOCATOR_PARANOID
+    try {
+        allocation_history.push_back({ptr, alignSize});
+    } catch (...) { // the history cannot grow, leave the allocation undone
+        lastbuffer.offset -= alignSize;
+        return nullptr;
+    }
+#endif
+
+    return ptr;
+}
+
+inline void stack_allocator::deallocate(void* ptr) {
+    deallocate<default_check_policy>(ptr);
+}
+
+// Unchecked frees trust ptr to be an allocation of the top buffer. Checked ones take the fast
+// path when ptr lies inside the top buffer, below the top. Paranoid ones check the LIFO order
+// against the history out of line.
+template <check_policy Policy> inline void stack_allocator::deallocate(void* ptr) {
+    auto* raw_ptr = static_cast<std::byte*>(ptr);
+
+    if constexpr (Policy == check_policy::unchecked) {
+        drop_to(raw_ptr);
+    } else {
+        if (Policy == check_policy::checked && !buffers.empty()) {
+            auto* start = buffers.back().memory.get();
+
+            // freeing the start of a later buffer drops that buffer, left to the slow path
+            if (raw_ptr > start && raw_ptr < start + buffers.back().offset) {
+                drop_to(raw_ptr);
+                return;
+            }
+        }
+        deallocate_slow<Policy>(ptr);
+    }
+}
+
+inline void stack_allocator::drop_to(std::byte* ptr) noexcept {
+    auto& lastbuffer = buffers.back();
+    lastbuffer.offset = ptr - lastbuffer.memory.get();
+    m_lastallocation = 0;
+
+#if ALLOCATOR_DEBUG || ALLOCATOR_PARANOID
+    trim_history();
+#endif
+
+    // Drop empty buffer unless it's the only one
+    if (lastbuffer.offset == 0 && buffers.size() > 1) {
+        buffers.pop_back();
+    }
+}
+
+} // namespace allocator
+
+#endif // STACK_ALLOCATOR_HPP
@@ -0,0 +1,113 @@
+#ifndef TLSF_ALLOCATOR_HPP
+#define TLSF_ALLOCATOR_HPP
+
+#include "allocator/allocator_interface.hpp"
+#include "allocator/memory_provider.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace allocator {
+
+// Two-Level Segregated Fit allocator (Masmano et al.). Free blocks sit in segregated lists
+// indexed by a first level (power of two of the size) and a second level (32 linear steps
+// within it). Two bitmaps locate a suitable non-empty list with a couple of bit scans, so
+// allocate and deallocate take constant time whatever the state of the heap. A freed block is
+// merged right away with free neighbours found through boundary tags.
+class tlsf_allocator : public AllocatorInterface {
+  public:
+    // the buffer comes from provider, operator new when null
+    explicit tlsf_allocator(size_t bufferSize, memory_provider* provider = nullptr);
+    ~tlsf_allocator() override;
+
+    // alignment 0 means 8 bytes, larger powers of two are served by trimming a leading gap
+    [[nodiscard]] virtual void* allocate(size_t size, size_t alignment = 0) override;
+    [[nodiscard]] virtual std::expected<void*, alloc_error>
+    try_allocate(size_t size, size_t alignment = 0) noexcept override;
+    virtual void deallocate(void* ptr) override;
+    using AllocatorInterface::deallocate; // sized overload, the size is not needed
+    virtual size_t getAllocatedSize() const override;
+    virtual size_t getObjectSize() const override; // granted size of the last allocation
+    virtual void reset() override;
+    virtual void setAllocatorName(std::string_view name) override;
+    void releaseMemory();
+
+    // disable copy and move
+    tlsf_allocator(const tlsf_allocator&) = delete;
+    tlsf_allocator& operator=(const tlsf_allocator&) = delete;
+    tlsf_allocator(tlsf_allocator&&) = delete;
+    tlsf_allocator& operator=(tlsf_allocator&&) = delete;
+
+  private:
+    // Only size is live while a block is used. prev_phys is the boundary tag: it occupies the
+    // last word of the previous block and is valid only while that block is free.
+    struct block_header {
+        block_header* prev_phys;
+        size_t size;             // payload size, the low bits hold BLOCK_FREE and PREV_FREE
+        block_header* next_free; // free blocks only
+        block_header* prev_free;
+    };
+
+    static constexpr size_t BLOCK_FREE = 1;
+    static constexpr size_t PREV_FREE = 2;
+
+    static constexpr size_t ALIGN_SIZE = 8;
+    static constexpr int SL_INDEX_COUNT_LOG2 = 5;
+    static constexpr int SL_INDEX_COUNT = 1 << SL_INDEX_COUNT_LOG2;
+    static constexpr int FL_INDEX_SHIFT = SL_INDEX_COUNT_LOG2 + 3; // log2(ALIGN_SIZE) = 3
+    static constexpr int FL_INDEX_MAX = 28;                         // blocks below 256 MB
+    static constexpr int FL_INDEX_COUNT = FL_INDEX_MAX - FL_INDEX_SHIFT + 1;
+    static constexpr size_t SMALL_BLOCK_SIZE = size_t{1} << FL_INDEX_SHIFT; // 256 bytes
+
+    static constexpr size_t BLOCK_OVERHEAD = sizeof(size_t);
+    static constexpr size_t BLOCK_START_OFFSET = offsetof(block_header, size) + sizeof(size_t);
+    static constexpr size_t BLOCK_SIZE_MIN = sizeof(block_header) - sizeof(block_header*);
+    static constexpr size_t BLOCK_SIZE_MAX = size_t{1} << FL_INDEX_MAX;
+    static constexpr size_t MIN_CAPACITY = 1024;                 // 1KB
+    static constexpr size_t MAX_CAPACITY = 128ull * 1024 * 1024; // 128 MB
+
+    // block layout helpers
+    static size_t get_block_size(const block_header* block);
+    static void set_block_size(block_header* block, size_t size);
+    static std::byte* to_ptr(block_header* block);
+    static block_header* from_ptr(void* ptr);
+    static block_header* next_block(block_header* block);
+    static block_header* link_next(block_header* block); // set the boundary tag of the next
+    static void mark_free(block_header* block);
+    static void mark_used(block_header* block);
+    static bool can_split(const block_header* block, size_t size);
+    static block_header* split(block_header* block, size_t size); // returns the remainder
+    static block_header* absorb(block_header* prev, block_header* block);
+
+    // size -> (first level, second level)
+    static void mapping_insert(size_t size, int& fl, int& sl);
+    static void mapping_search(size_t size, int& fl, int& sl); // rounds up to the next list
+
+    void insert_free_block(block_header* block);
+    void remove_free_block(block_header* block);
+    block_header* locate_free_block(size_t size);
+    void trim_free(block_header* block, size_t size);
+    block_header* trim_free_leading(block_header* block, size_t gap);
+    block_header* merge_prev(block_header* block);
+    block_header* merge_next(block_header* block);
+
+    void allocate_new_buffer();
+    void init_pool();
+
+    provider_ptr m_memory;
+    size_t m_bufferSize;
+    bool m_ownsMemory = false;
+    memory_provider* m_provider; // not owned
+
+    std::uint32_t m_flBitmap = 0;                         // bit fl set when level fl has a block
+    std::array<std::uint32_t, FL_INDEX_COUNT> m_slBitmap{}; // bit sl set when list is non-empty
+    std::array<std::array<block_header*, SL_INDEX_COUNT>, FL_INDEX_COUNT> m_blocks{};
+
+    size_t m_allocatedSize = 0;
+    size_t m_lastAllocation = 0;
+    std::string m_allocator = "tlsf_allocator"; // Custom Name for debugging
+};
+
+} // namespace allocator
+
+#endif // TLSF_ALLOCATOR_HPP
@@ -0,0 +1,81 @@
+#ifndef TREE_BUDDY_ALLOCATOR_HPP
+#define TREE_BUDDY_ALLOCATOR_HPP
+
+#include "allocator/allocator_interface.hpp"
+#include "allocator/memory_provider.hpp"
+#include <cstdint>
+#include <limits>
+
+namespace allocator {
+
+// Buddy allocator whose metadata lives entirely outside the managed range: an implicit binary
+// tree (heap layout, children of node i at 2i+1 and 2i+2) stores for every node the order of
+// the longest free run below it. Allocation descends from the root and freeing climbs from a
+// leaf, both O(log n) array walks with no pointer chasing and no writes to the managed range.
+//
+// With backed = true the allocator owns a buffer and hands out pointers like buddy_allocator.
+// With backed = false it only manages the abstract range [0, capacity) through
+// allocate_range()/deallocate_range(), e.g. for file offsets, mmap regions or device arenas.
+class tree_buddy_allocator : public AllocatorInterface {
+  public:
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    // a backed buffer comes from provider, operator new when null
+    explicit tree_buddy_allocator(size_t capacity, size_t minBlock = 1024, bool backed = true,
+                                  memory_provider* provider = nullptr);
+    ~tree_buddy_allocator() override;
+
+    [[nodiscard]] virtual void* allocate(size_t size, // here alignment is ignored
+                                         [[maybe_unused]] size_t alignment = 0) override;
+    [[nodiscard]] virtual std::expected<void*, alloc_error>
+    try_allocate(size_t size, [[maybe_unused]] size_t alignment = 0) noexcept override;
+    virtual void deallocate(void* ptr) override;
+    using AllocatorInterface::deallocate; // sized overload, the size is not needed
+    virtual size_t getAllocatedSize() const override;
+    virtual size_t getObjectSize() const override;
+    virtual void reset() override;
+    virtual void setAllocatorName(std::string_view name) override;
+    void releaseMemory();
+
+    // Range interface, works in both modes. Returns the offset of a block of at least size
+    // units (rounded up to a power-of-two number of minBlock), or npos if none is free.
+    [[nodiscard]] size_t allocate_range(size_t size);
+    void deallocate_range(size_t offset);
+
+    // disable copy and move
+    tree_buddy_allocator(const tree_buddy_allocator&) = delete;
+    tree_buddy_allocator& operator=(const tree_buddy_allocator&) = delete;
+    tree_buddy_allocator(tree_buddy_allocator&&) = delete;
+    tree_buddy_allocator& operator=(tree_buddy_allocator&&) = delete;
+
+  private:
+    // node value: order + 1 of the longest free run below the node, 0 when nothing is free.
+    // ALLOCATED marks the node an allocation was carved at, so freeing can find it again.
+    static constexpr std::uint8_t ALLOCATED = 0x80;
+    static constexpr std::uint8_t LONGEST_MASK = 0x7f;
+    static constexpr size_t MAX_LEAVES = size_t{1} << 28;
+    static constexpr size_t MAX_CAPACITY = 128ull * 1024 * 1024; // 128 MB when backed
+
+    void allocate_new_buffer();
+    void build_tree();
+    void update_parents(size_t index, unsigned order); // recompute the ancestors of a node
+    std::uint8_t combine(size_t index, unsigned order) const; // value from the two children
+
+    std::unique_ptr<std::uint8_t[]> m_tree;
+    provider_ptr m_memory; // backing buffer, empty for abstract ranges
+    size_t m_capacity;     // managed units, rounded up to minBlock
+    size_t m_minBlock;
+    unsigned m_minShift; // log2(m_minBlock)
+    size_t m_leaves;     // power of two >= capacity / minBlock
+    unsigned m_maxOrder; // order of the root node
+    bool m_backed;
+    bool m_ownsMemory = false;
+    memory_provider* m_provider; // not owned
+    size_t m_allocatedSize = 0;
+    size_t m_lastAllocation = 0;
+    std::string m_allocator = "tree_buddy_allocator"; // Custom Name for debugging
+};
+
+} // namespace allocator
+
+#endif // TREE_BUDDY_ALLOCATOR_HPP
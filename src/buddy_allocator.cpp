@@ -1,22 +1,48 @@
 #include "allocator/buddy_allocator.hpp"
+#include <algorithm>
+#include <bit>
 #include <cassert>
 #include <cmath>
 #include <cstring>
 #include <iostream>
 
+#if defined(__unix__) || defined(__APPLE__)
+#define ALLOCATOR_HAS_MMAP 1
+#endif
+
 #if ALLOCATOR_DEBUG
 #define handle_allocation_error(msg) throwAllocationError(m_allocator, msg)
 #else
 #define handle_allocation_error(msg) return nullptr
 #endif
 
-allocator::buddy_allocator::buddy_allocator(size_t buffersize) {
+namespace {
+allocator::memory_provider* mode_provider(allocator::buddy_allocator::buffer_mode mode) {
+    if (mode == allocator::buddy_allocator::buffer_mode::mmap) {
+        static allocator::mmap_provider provider;
+        return &provider;
+    }
+    return allocator::default_memory_provider();
+}
+} // namespace
+
+allocator::buddy_allocator::buddy_allocator(size_t buffersize, split_policy policy,
+                                            buffer_mode mode, memory_provider* provider)
+    : m_policy(policy), m_provider(provider ? provider : mode_provider(mode)) {
     if (buffersize < MIN_CAPACITY || buffersize > MAX_CAPACITY) {
         throw std::invalid_argument("Buffer size must be between" +
                                     std::to_string(MIN_CAPACITY / 1024) + "KB and " +
                                     std::to_string(MAX_CAPACITY / 1024 * 1024) + "MB");
     }
-    m_buffersize = get_power_of_two(buffersize);
+    // keep the requested size (rounded to the minimum block granularity) instead of the next
+    // power of two, the region is carved into power-of-two root blocks in allocate_new_buffer()
+    m_buffersize = getAlignedSize(buffersize, MIN_CAPACITY);
+
+#ifndef ALLOCATOR_HAS_MMAP
+    if (!provider && mode == buffer_mode::mmap) {
+        throw std::invalid_argument(m_allocator + ": mmap buffers are not supported here");
+    }
+#endif
 
     allocate_new_buffer();
 }
@@ -25,54 +51,242 @@ allocator::buddy_allocator::~buddy_allocator() {
     releaseMemory();
 }
 
-void* allocator::buddy_allocator::allocate(size_t size, [[maybe_unused]] size_t alignment) {
+// the moved-from side keeps the configuration and is left without memory by the swap
+allocator::buddy_allocator::buddy_allocator(buddy_allocator&& other) noexcept
+    : m_buffersize(other.m_buffersize), m_policy(other.m_policy), m_provider(other.m_provider),
+      m_purgeLevel(other.m_purgeLevel), m_purgeOnFree(other.m_purgeOnFree) {
+    m_cacheLimit = other.m_cacheLimit;
+    swap(other);
+}
+
+allocator::buddy_allocator&
+allocator::buddy_allocator::operator=(buddy_allocator&& other) noexcept {
+    if (this != &other) {
+        swap(other);
+        other.releaseMemory(); // our old buffer goes with the moved-from side
+    }
+    return *this;
+}
+
+void allocator::buddy_allocator::swap(buddy_allocator& other) noexcept {
+    // the free lists, slabs and maps point into the buffer or into map nodes, neither of which
+    // moves, so swapping every member keeps both sides consistent
+    using std::swap;
+    swap(freeLists, other.freeLists);
+    swap(allocatedBuddies, other.allocatedBuddies);
+    swap(m_slabs, other.m_slabs);
+    swap(partialSlabs, other.partialSlabs);
+    swap(slabIndex, other.slabIndex);
+    swap(freeLevels, other.freeLevels);
+    swap(freeBitmaps, other.freeBitmaps);
+    swap(cachedLists, other.cachedLists);
+    swap(cachedCounts, other.cachedCounts);
+    swap(m_cacheLimit, other.m_cacheLimit);
+    swap(freeCounts, other.freeCounts);
+    swap(m_freeMask, other.m_freeMask);
+    swap(m_freeBytes, other.m_freeBytes);
+    swap(m_allocatedBytes, other.m_allocatedBytes);
+    swap(m_requestedBytes, other.m_requestedBytes);
+    swap(m_lastAllocation, other.m_lastAllocation);
+    swap(m_buffer, other.m_buffer);
+    swap(m_buffersize, other.m_buffersize);
+    swap(m_policy, other.m_policy);
+    swap(m_provider, other.m_provider);
+    swap(m_purgeLevel, other.m_purgeLevel);
+    swap(m_purgeOnFree, other.m_purgeOnFree);
+    swap(m_ownsMemory, other.m_ownsMemory);
+    swap(m_allocator, other.m_allocator);
+}
+
+void* allocator::buddy_allocator::allocate_slow(size_t size, size_t alignment) {
+    auto result = try_allocate_slow(size, alignment);
+    if (!result) {
+        handle_allocation_error(describeAllocationError(result.error(), size));
+    }
+    return *result;
+}
+
+std::expected<void*, allocator::alloc_error>
+allocator::buddy_allocator::try_allocate_slow(size_t size, size_t alignment) noexcept {
 
     // this function takes alignment parameter for polymorphism, but alignment is ignored in buddy
-    // allocator
+    // allocator, except that it can move a small request to a larger slab size class
 
+    if (!m_ownsMemory) {
+        return std::unexpected(alloc_error::no_memory);
+    }
+
+    // the bookkeeping maps allocate, running out of heap there is reported like a full buffer
+    try {
+        // small requests share a minimum block with other objects of the same size class
+        if (std::max(size, alignment) <= MAX_SLAB_OBJECT) {
+            slab* s = get_partial_slab(get_slab_class(size, alignment));
+            if (!s) {
+                return std::unexpected(alloc_error::out_of_memory);
+            }
+            return take_slab_object(s, size);
+        }
+
+        if (size > get_level_size(m_buffer.initial_level)) {
+            return std::unexpected(alloc_error::size_too_large);
+        }
+
+        // Find the appropriate free block
+        Buddy* buddy = acquire_block(get_level(get_power_of_two(size)));
+        if (!buddy) {
+            return std::unexpected(alloc_error::out_of_memory);
+        }
+
+        return record_allocation(buddy, size);
+    } catch (const std::bad_alloc&) {
+        return std::unexpected(alloc_error::out_of_memory);
+    }
+}
+
+allocator::allocation_result<void*>
+allocator::buddy_allocator::allocate_at_least(size_t size, size_t alignment) {
+    void* ptr = allocate(size, alignment);
+    return {ptr, ptr ? m_lastAllocation : 0};
+}
+
+void* allocator::buddy_allocator::allocate(size_t size, lifetime hint) {
     if (!m_ownsMemory) {
         handle_allocation_error("Allocator has released its memory");
     }
 
-    if (size > m_buffersize) {
-        handle_allocation_error("Requested size exceeds buffer size");
+    // slabs are shared by objects of any lifetime
+    if (size <= MAX_SLAB_OBJECT) {
+        return allocate_small(size, 0);
     }
 
-    // Find the appropriate free block
+    if (size > get_level_size(m_buffer.initial_level)) {
+        handle_allocation_error("Requested size exceeds largest block size");
+    }
 
+    // parked blocks sit anywhere in the buffer, so hinted requests bypass the caches
     auto actualSize = get_power_of_two(size);
     int level = get_level(actualSize);
-    Buddy* buddy = get_first_free_buddy(level);
+    bool high = hint == lifetime::short_lived;
+    Buddy* buddy = take_placed_block(level, high);
+    if (!buddy && m_cacheLimit) {
+        flush_cached_blocks();
+        buddy = take_placed_block(level, high);
+    }
     if (!buddy) {
-        // No free block at this level, try to find a larger block and split it
-        int nonEmptyLevel = find_non_empty_level(level + 1);
-        if (nonEmptyLevel == -1) {
-            handle_allocation_error("No sufficient block available for allocation(" +
-                                    std::to_string(actualSize) + ")");
-        }
+        handle_allocation_error("No sufficient block available for allocation(" +
+                                std::to_string(actualSize) + ")");
+    }
+
+    return record_allocation(buddy, size);
+}
+
+void* allocator::buddy_allocator::record_allocation(Buddy* buddy, size_t size) {
+    size_t actualSize = get_power_of_two(size);
+    size_t grantedSize = get_granted_size(size);
+    int level = get_level(actualSize);
+
+    // Mark the block as allocated first, it goes back whole when the map cannot grow
+    try {
+        allocatedBuddies.try_emplace(buddy, block_info{level, grantedSize, size, nullptr});
+    } catch (const std::bad_alloc&) {
+        release_block(buddy, level);
+        throw;
+    }
+
+    // Give the unused tail back as the minimal set of trailing buddies
+    if (grantedSize < actualSize) {
+        uintptr_t offset = reinterpret_cast<uintptr_t>(buddy) - m_buffer.start_address_int;
+        release_range(offset + grantedSize, offset + actualSize, false);
+    }
 
-        Buddy* largerBuddy = nullptr;
+    m_allocatedBytes += grantedSize;
+    m_requestedBytes += size;
+    m_lastAllocation = grantedSize;
+    return reinterpret_cast<void*>(buddy);
+}
 
-        // Split blocks down to the desired level
-        while (nonEmptyLevel > level) {
+size_t allocator::buddy_allocator::allocate_n(size_t size, size_t count, void** out) {
+    if (!m_ownsMemory || count == 0) {
+        return 0;
+    }
 
-            if (!largerBuddy) {
-                largerBuddy = get_first_free_buddy(nonEmptyLevel);
-            } else {
-                largerBuddy = buddy; // use the previously split buddy
+    if (size > get_level_size(m_buffer.initial_level)) {
+        return 0;
+    }
+
+    size_t done = 0;
+
+    // small requests: fill each slab before carving the next one
+    if (size <= MAX_SLAB_OBJECT) {
+        int sizeClass = get_slab_class(size, 0);
+        while (done < count) {
+            slab* s = get_partial_slab(sizeClass);
+            if (!s) {
+                break;
             }
+            while (done < count && s->freeMask != 0) {
+                out[done++] = take_slab_object(s, size);
+            }
+        }
+        return done;
+    }
+
+    int level = get_level(get_power_of_two(size));
+    size_t blockSize = get_level_size(level);
+    size_t grantedSize = get_granted_size(size);
+    allocatedBuddies.reserve(allocatedBuddies.size() + count);
 
-            if (!largerBuddy) {
-                handle_allocation_error("Inconsistent state: expected a free block");
+    auto hand_out = [&](uintptr_t offset) {
+        if (grantedSize < blockSize) {
+            release_range(offset + grantedSize, offset + blockSize, false);
+        }
+        void* ptr = reinterpret_cast<void*>(m_buffer.start_address_int + offset);
+        allocatedBuddies.emplace(ptr, block_info{level, grantedSize, size, nullptr});
+        out[done++] = ptr;
+    };
+
+    // blocks parked by lazy coalescing already have the right size
+    while (m_cacheLimit && done < count) {
+        Buddy* cached = take_cached_block(level);
+        if (!cached) {
+            break;
+        }
+        hand_out(reinterpret_cast<uintptr_t>(cached) - m_buffer.start_address_int);
+    }
+
+    bool flushed = false;
+    while (done < count) {
+        int freeLevel = find_non_empty_level(level);
+        if (freeLevel == -1) {
+            if (m_cacheLimit && !flushed) {
+                flush_cached_blocks(); // deferred frees may coalesce into usable blocks
+                flushed = true;
+                continue;
             }
-            buddy = split_buddy(largerBuddy, nonEmptyLevel);
-            nonEmptyLevel--;
+            break;
+        }
+
+        // Take the smallest free block that fits and cut it into consecutive pieces in one go,
+        // instead of one split walk per request. Pieces not needed go back as maximal blocks,
+        // nothing smaller than freeLevel was free so they cannot merge with anything.
+        Buddy* block = get_first_free_buddy(freeLevel);
+        uintptr_t offset = reinterpret_cast<uintptr_t>(block) - m_buffer.start_address_int;
+        size_t pieces = size_t{1} << (freeLevel - level);
+        size_t used = std::min(pieces, count - done);
+        for (size_t i = 0; i < used; ++i) {
+            hand_out(offset + i * blockSize);
+        }
+        if (used < pieces) {
+            release_range(offset + used * blockSize, offset + pieces * blockSize, false);
         }
     }
 
-    // Mark the block as allocated
-    allocatedBuddies[reinterpret_cast<void*>(buddy)] = level;
-    return reinterpret_cast<void*>(buddy);
+    m_allocatedBytes += done * grantedSize;
+    m_requestedBytes += done * size;
+    if (done) {
+        m_lastAllocation = grantedSize;
+    }
+    return done;
 }
 
 void allocator::buddy_allocator::deallocate(void* ptr) {
@@ -85,34 +299,186 @@ void allocator::buddy_allocator::deallocate(void* ptr) {
         throw std::invalid_argument(m_allocator + ": Allocator has released its memory");
     }
 
-    auto it = allocatedBuddies.find(ptr);
+    auto it = find_allocation(ptr);
     if (it == allocatedBuddies.end()) {
         throw std::invalid_argument(
             m_allocator + ": Pointer not allocated by this allocator or double free detected");
     }
 
-    int level = it->second;
+    if (it->second.owner) {
+        free_small(it->second.owner, ptr);
+        return;
+    }
+
+    auto [level, size, requested, owner] = it->second;
     allocatedBuddies.erase(it);
+    m_allocatedBytes -= size;
+    m_requestedBytes -= requested;
+
+    uintptr_t offset = reinterpret_cast<uintptr_t>(ptr) - m_buffer.start_address_int;
+    if (size != get_level_size(level) || offset % size != 0) {
+        // trimmed or resized allocation: free every block of the recorded extent, the trailing
+        // ones merge back with the buddies released at allocation time
+        release_range(offset, offset + size, true);
+        return;
+    }
 
-    Buddy* buddy = reinterpret_cast<Buddy*>(ptr);
-    add_to_free_list(buddy, level);
+    release_block(reinterpret_cast<Buddy*>(ptr), level);
+}
 
-    // Try to merge with buddy
-    try_merge_buddies(buddy, level);
+void allocator::buddy_allocator::deallocate(void* ptr, size_t size, size_t alignment) {
+    // a slab-sized request was served by a slab, whose record is one array read away
+    if (std::max(size, alignment) <= MAX_SLAB_OBJECT && m_ownsMemory) {
+        uintptr_t offset = reinterpret_cast<uintptr_t>(ptr) - m_buffer.start_address_int;
+        if (offset < slabIndex.size() * MIN_CAPACITY) {
+            slab* s = slabIndex[offset / MIN_CAPACITY];
+            if (s && s->sizeClass == get_slab_class(size, alignment)) {
+                free_small(s, ptr);
+                return;
+            }
+        }
+    }
+
+    // larger sizes still need the map entry, and a mismatched size is checked the slow way
+    deallocate(ptr);
+}
+
+void* allocator::buddy_allocator::reallocate(void* ptr, size_t newSize) {
+    if (!ptr) {
+        return allocate(newSize);
+    }
+
+    if (!m_ownsMemory) {
+        throw std::invalid_argument(m_allocator + ": Allocator has released its memory");
+    }
+
+    auto it = find_allocation(ptr);
+    if (it == allocatedBuddies.end()) {
+        throw std::invalid_argument(m_allocator + ": Pointer not allocated by this allocator");
+    }
+
+    if (newSize > get_level_size(m_buffer.initial_level)) {
+        handle_allocation_error("Requested size exceeds largest block size");
+    }
+
+    if (it->second.owner) {
+        // slab objects stay put while the new size keeps their size class
+        slab* s = it->second.owner;
+        size_t objectSize = get_slab_object_size(s->sizeClass);
+        if (get_slab_class(newSize, 0) == s->sizeClass) {
+            size_t oldRequested = s->requested / s->used;
+            s->requested = s->requested - oldRequested + newSize;
+            m_requestedBytes = m_requestedBytes - oldRequested + newSize;
+            return ptr;
+        }
+
+        void* newPtr = allocate(newSize);
+        if (!newPtr) {
+            return nullptr;
+        }
+        std::memcpy(newPtr, ptr, std::min(objectSize, newSize));
+        deallocate(ptr);
+        return newPtr;
+    }
+
+    size_t oldSize = it->second.size;
+    size_t oldRequested = it->second.requested;
+    size_t grantedSize = get_granted_size(newSize);
+    uintptr_t offset = reinterpret_cast<uintptr_t>(ptr) - m_buffer.start_address_int;
+
+    // Shrink in place: the upper part goes back to the free lists
+    if (grantedSize <= oldSize) {
+        release_range(offset + grantedSize, offset + oldSize, true);
+        it->second = {get_level(get_power_of_two(grantedSize)), grantedSize, newSize, nullptr};
+        m_allocatedBytes = m_allocatedBytes - oldSize + grantedSize;
+        m_requestedBytes = m_requestedBytes - oldRequested + newSize;
+        return ptr;
+    }
+
+    // Grow in place by absorbing the free blocks that follow the extent
+    if (try_grow_in_place(offset, oldSize, grantedSize)) {
+        it->second = {get_level(get_power_of_two(grantedSize)), grantedSize, newSize, nullptr};
+        m_allocatedBytes = m_allocatedBytes - oldSize + grantedSize;
+        m_requestedBytes = m_requestedBytes - oldRequested + newSize;
+        return ptr;
+    }
+
+    // Neither is possible, move the data to a new block
+    void* newPtr = allocate(newSize);
+    if (!newPtr) {
+        return nullptr; // the old block stays valid, like realloc
+    }
+    std::memcpy(newPtr, ptr, oldSize);
+    deallocate(ptr);
+    return newPtr;
 }
 
 size_t allocator::buddy_allocator::getAllocatedSize() const {
-    size_t totalAllocated = 0;
-    for (const auto& [ptr, level] : allocatedBuddies) {
-        totalAllocated += get_level_size(level);
+    return m_allocatedBytes;
+}
+
+allocator::buddy_allocator::buddy_stats allocator::buddy_allocator::getStats() const {
+    buddy_stats stats;
+    stats.allocated_bytes = m_allocatedBytes;
+    stats.requested_bytes = m_requestedBytes;
+    stats.free_bytes = m_freeBytes;
+    stats.free_blocks = freeCounts;
+    stats.slab_bytes = m_slabs.size() * MIN_CAPACITY;
+
+    for (int level = 0; level < static_cast<int>(cachedCounts.size()); ++level) {
+        stats.cached_bytes += cachedCounts[level] * get_level_size(level);
+    }
+
+    if (m_freeMask != 0) {
+        stats.largest_free_block = get_level_size(std::bit_width(m_freeMask) - 1);
+    }
+
+    if (m_allocatedBytes != 0) {
+        stats.internal_fragmentation =
+            1.0 - static_cast<double>(m_requestedBytes) / static_cast<double>(m_allocatedBytes);
+    }
+
+    if (m_freeBytes != 0) {
+        stats.external_fragmentation = 1.0 - static_cast<double>(stats.largest_free_block) /
+                                                 static_cast<double>(m_freeBytes);
     }
-    return totalAllocated;
+
+    return stats;
 }
 
 void allocator::buddy_allocator::setAllocatorName(std::string_view name) {
     m_allocator = name;
 }
 
+void allocator::buddy_allocator::setLazyCoalescing(size_t cacheLimit) {
+    if (cacheLimit == 0 && m_ownsMemory) {
+        flush_cached_blocks(); // leaving lazy mode, merge everything that was deferred
+    }
+    m_cacheLimit = cacheLimit;
+}
+
+void allocator::buddy_allocator::setPurgeThreshold(size_t minBlockSize, bool onFree) {
+    m_purgeLevel = get_level(get_power_of_two(std::max(minBlockSize, MIN_CAPACITY)));
+    m_purgeOnFree = onFree;
+}
+
+size_t allocator::buddy_allocator::purge() {
+    if (!m_ownsMemory) {
+        return 0;
+    }
+
+    // parked blocks may coalesce into purgeable ones
+    flush_cached_blocks();
+
+    size_t released = 0;
+    for (int level = m_purgeLevel; level <= m_buffer.initial_level; ++level) {
+        for (Buddy* buddy = freeLists[level]; buddy; buddy = buddy->next_free) {
+            released += purge_block(buddy, level, true);
+        }
+    }
+    return released;
+}
+
 void allocator::buddy_allocator::reset() {
     if (m_ownsMemory) {
         // Clear allocated buddies
@@ -122,16 +488,22 @@ void allocator::buddy_allocator::reset() {
         for (auto& list : freeLists) {
             list = nullptr;
         }
+        std::fill(freeLevels.begin(), freeLevels.end(), -1);
+        std::fill(slabIndex.begin(), slabIndex.end(), nullptr);
+        init_free_bitmaps();
+        cachedLists.fill(nullptr);
+        cachedCounts.fill(0);
+        m_slabs.clear();
+        partialSlabs.fill(nullptr);
+        reset_counters();
 
 #if ALLOCATOR_DEBUG
         std::memset(m_buffer.start_address, 0,
                     m_buffer.size); // Optional: Clear memory for debugging
 #endif
 
-        // Reinitialize the free list with a single large block
-        int level = get_level(m_buffersize);
-        Buddy* buddy = reinterpret_cast<Buddy*>(m_buffer.start_address);
-        add_to_free_list(buddy, level);
+        // Reinitialize the free lists with the root blocks
+        add_root_blocks();
     } else {
         allocate_new_buffer();
     }
@@ -150,10 +522,26 @@ void allocator::buddy_allocator::releaseMemory() {
     for (auto& list : freeLists) {
         list = nullptr;
     }
+    freeLevels.clear();
+    slabIndex.clear();
+    for (auto& bitmap : freeBitmaps) {
+        bitmap.words.clear();
+        bitmap.summary.clear();
+    }
+    cachedLists.fill(nullptr);
+    cachedCounts.fill(0);
+    m_slabs.clear();
+    partialSlabs.fill(nullptr);
+    reset_counters();
+}
 
-#if ALLOCATOR_DEBUG
-    std::memset(m_buffer.start_address, 0, m_buffer.size); // Optional: Clear memory for debugging
-#endif
+void allocator::buddy_allocator::reset_counters() {
+    freeCounts.fill(0);
+    m_freeMask = 0;
+    m_freeBytes = 0;
+    m_allocatedBytes = 0;
+    m_requestedBytes = 0;
+    m_lastAllocation = 0;
 }
 
 void allocator::buddy_allocator::allocate_new_buffer() {
@@ -161,18 +549,39 @@ void allocator::buddy_allocator::allocate_new_buffer() {
         releaseMemory();
     }
 
-    m_buffer.memory = std::make_unique<std::byte[]>(m_buffersize);
-    int level = get_level(m_buffersize);
+    // page aligned, so purge_block() can hand whole pages of large blocks back and slab
+    // objects are aligned to their class size in memory
+    m_buffer.memory = acquire_buffer(*m_provider, m_buffersize, memory_provider::page_size());
+    if (!m_buffer.memory) {
+        throw std::bad_alloc();
+    }
 
     m_buffer.size = m_buffersize;
     m_buffer.start_address = m_buffer.memory.get();
-    m_buffer.initial_level = level;
+    m_buffer.initial_level = get_level(std::bit_floor(m_buffersize)); // level of the largest root
     m_buffer.start_address_int = reinterpret_cast<uintptr_t>(m_buffer.start_address);
+    freeLevels.assign(m_buffersize / MIN_CAPACITY, -1);
+    slabIndex.assign(m_buffersize / MIN_CAPACITY, nullptr);
+    init_free_bitmaps();
     m_ownsMemory = true;
 
-    // Initialize the free list with a single large block
-    Buddy* buddy = reinterpret_cast<Buddy*>(m_buffer.start_address);
-    add_to_free_list(buddy, level);
+    // Initialize the free lists with the root blocks
+    add_root_blocks();
+}
+
+void allocator::buddy_allocator::add_root_blocks() {
+    // Carve the buffer into maximal power-of-two roots, largest first (96KB = 64KB + 32KB).
+    // Placing them in descending order keeps every root aligned to its own size, so the usual
+    // offset ^ size buddy computation never has to know where one root ends and the next begins.
+    size_t offset = 0;
+    for (int level = m_buffer.initial_level; level >= 0; --level) {
+        size_t rootSize = get_level_size(level);
+        if (m_buffer.size & rootSize) {
+            Buddy* root = reinterpret_cast<Buddy*>(m_buffer.start_address_int + offset);
+            add_to_free_list(root, level);
+            offset += rootSize;
+        }
+    }
 }
 
 int allocator::buddy_allocator::get_level(size_t size) {
@@ -191,35 +600,70 @@ size_t allocator::buddy_allocator::get_power_of_two(size_t size) {
     return power;
 }
 
+size_t allocator::buddy_allocator::get_granted_size(size_t size) const {
+    if (m_policy == split_policy::trim_tail) {
+        return getAlignedSize(size == 0 ? 1 : size, MIN_CAPACITY);
+    }
+
+    size_t blockSize = get_power_of_two(size);
+    if (m_policy == split_policy::weighted && blockSize >= 4 * MIN_CAPACITY) {
+        // The 3*2^k extent is the lower half plus the third quarter of the block, the last
+        // quarter is a free buddy of its own. Freeing releases the two parts as ordinary binary
+        // buddies, so they coalesce with that quarter and the usual merge rule stays correct.
+        size_t threeQuarters = blockSize / 4 * 3;
+        if (size <= threeQuarters) {
+            return threeQuarters;
+        }
+    }
+    return blockSize;
+}
+
 size_t allocator::buddy_allocator::get_level_size(int level) {
     return MIN_CAPACITY << level; // 1KB * 2^level
 }
 
 void allocator::buddy_allocator::add_to_free_list(Buddy* buddy, int level) {
+    // a split half or a merged block holds pages of blocks that were in use, or at least the
+    // header page of its other half, so it starts out unpurged
+    buddy->purged = purge_state::none;
+    buddy->prev_free = nullptr;
     buddy->next_free = freeLists[level];
-    buddy->level = level;
+    if (freeLists[level]) {
+        freeLists[level]->prev_free = buddy;
+    }
     freeLists[level] = buddy;
+    freeLevels[(reinterpret_cast<uintptr_t>(buddy) - m_buffer.start_address_int) / MIN_CAPACITY] =
+        static_cast<std::int8_t>(level);
+    set_free_bit(buddy, level, true);
+
+    ++freeCounts[level];
+    m_freeMask |= 1u << level;
+    m_freeBytes += get_level_size(level);
 }
 
 void allocator::buddy_allocator::remove_from_free_list(Buddy* buddy, int level) {
-    if (!freeLists[level])
-        return;
+    if (!is_free_at_level(buddy, level)) {
+        throw std::runtime_error("Attempted to remove a buddy not in free list");
+    }
 
-    if (freeLists[level] == buddy) {
+    // doubly linked, so unlinking is O(1) instead of a walk from the head
+    if (buddy->prev_free) {
+        buddy->prev_free->next_free = buddy->next_free;
+    } else {
         freeLists[level] = buddy->next_free;
-        return;
     }
-
-    Buddy* current = freeLists[level];
-    while (current && current->next_free != buddy) {
-        current = current->next_free;
+    if (buddy->next_free) {
+        buddy->next_free->prev_free = buddy->prev_free;
     }
 
-    if (current && current->next_free == buddy) {
-        current->next_free = buddy->next_free;
-    } else {
-        throw std::runtime_error("Attempted to remove a buddy not in free list");
+    freeLevels[(reinterpret_cast<uintptr_t>(buddy) - m_buffer.start_address_int) / MIN_CAPACITY] =
+        -1;
+    set_free_bit(buddy, level, false);
+
+    if (--freeCounts[level] == 0) {
+        m_freeMask &= ~(1u << level);
     }
+    m_freeBytes -= get_level_size(level);
 }
 
 allocator::buddy_allocator::Buddy* allocator::buddy_allocator::get_first_free_buddy(int level) {
@@ -231,16 +675,130 @@ allocator::buddy_allocator::Buddy* allocator::buddy_allocator::get_first_free_bu
     return buddy;
 }
 
-int allocator::buddy_allocator::find_non_empty_level(int startLevel) {
+allocator::buddy_allocator::Buddy* allocator::buddy_allocator::take_free_block(int level) {
+    Buddy* buddy = get_first_free_buddy(level);
+    if (buddy) {
+        return buddy;
+    }
+
+    // No free block at this level, try to find a larger block and split it
+    int nonEmptyLevel = find_non_empty_level(level + 1);
+    if (nonEmptyLevel == -1) {
+        return nullptr;
+    }
+
+    // Split blocks down to the desired level, the upper halves go to the free lists
+    buddy = get_first_free_buddy(nonEmptyLevel);
+    while (nonEmptyLevel > level) {
+        buddy = split_buddy(buddy, nonEmptyLevel);
+        nonEmptyLevel--;
+    }
+    return buddy;
+}
 
-    int freeListsSize = static_cast<int>(freeLists.size());
+allocator::buddy_allocator::Buddy* allocator::buddy_allocator::take_placed_block(int level,
+                                                                                bool high) {
+    // the free block reaching furthest to the requested end of the buffer, whatever its size
+    Buddy* buddy = nullptr;
+    int freeLevel = -1;
+    uintptr_t best = 0;
+    for (int l = find_non_empty_level(level); l != -1; l = find_non_empty_level(l + 1)) {
+        Buddy* candidate = find_free_block(l, high);
+        uintptr_t position = high ? reinterpret_cast<uintptr_t>(candidate) + get_level_size(l)
+                                  : UINTPTR_MAX - reinterpret_cast<uintptr_t>(candidate);
+        if (!buddy || position > best) {
+            buddy = candidate;
+            freeLevel = l;
+            best = position;
+        }
+    }
+    if (!buddy) {
+        return nullptr;
+    }
 
-    for (int i = startLevel; i < freeListsSize; ++i) {
-        if (freeLists[i] != nullptr) {
-            return i;
+    remove_from_free_list(buddy, freeLevel);
+
+    // split down keeping the half on the requested side, the other half goes to the free list
+    while (freeLevel > level) {
+        --freeLevel;
+        auto* upper = reinterpret_cast<Buddy*>(reinterpret_cast<std::byte*>(buddy) +
+                                               get_level_size(freeLevel));
+        if (high) {
+            add_to_free_list(buddy, freeLevel);
+            buddy = upper;
+        } else {
+            add_to_free_list(upper, freeLevel);
         }
     }
-    return -1; // No non-empty level found
+    return buddy;
+}
+
+allocator::buddy_allocator::Buddy* allocator::buddy_allocator::acquire_block(int level) {
+    Buddy* buddy = m_cacheLimit ? take_cached_block(level) : nullptr;
+    if (!buddy) {
+        buddy = take_free_block(level);
+    }
+    if (!buddy && m_cacheLimit) {
+        // deferred frees may coalesce into a block large enough for this request
+        flush_cached_blocks();
+        buddy = take_free_block(level);
+    }
+    return buddy;
+}
+
+void allocator::buddy_allocator::release_block(Buddy* buddy, int level) {
+    if (m_cacheLimit) {
+        // lazy mode: park the block, it is merged only once its level's cache overflows
+        cache_block(buddy, level);
+        return;
+    }
+
+    add_to_free_list(buddy, level);
+
+    // Try to merge with buddy
+    try_merge_buddies(buddy, level);
+}
+
+allocator::buddy_allocator::Buddy* allocator::buddy_allocator::take_cached_block(int level) {
+    Buddy* buddy = cachedLists[level];
+    if (buddy) {
+        cachedLists[level] = buddy->next_free;
+        --cachedCounts[level];
+    }
+    return buddy;
+}
+
+void allocator::buddy_allocator::cache_block(Buddy* buddy, int level) {
+    buddy->next_free = cachedLists[level];
+    cachedLists[level] = buddy;
+
+    if (++cachedCounts[level] > m_cacheLimit) {
+        flush_cached_level(level);
+    }
+}
+
+void allocator::buddy_allocator::flush_cached_level(int level) {
+    // cached blocks are invisible to find_buddy() (freeLevels says -1), so they only become
+    // merge candidates once they are put back on the real free list here
+    while (Buddy* buddy = take_cached_block(level)) {
+        add_to_free_list(buddy, level);
+        try_merge_buddies(buddy, level);
+    }
+}
+
+void allocator::buddy_allocator::flush_cached_blocks() {
+    for (int level = 0; level < static_cast<int>(cachedLists.size()); ++level) {
+        flush_cached_level(level);
+    }
+}
+
+int allocator::buddy_allocator::find_non_empty_level(int startLevel) {
+    // lowest non-empty level at or above startLevel straight from the bitmask
+    std::uint32_t candidates = m_freeMask & (~0u << startLevel);
+    if (candidates == 0) {
+        return -1; // No non-empty level found
+    }
+    return std::countr_zero(candidates);
 }
 
 allocator::buddy_allocator::Buddy* allocator::buddy_allocator::split_buddy(Buddy* b, int level) {
@@ -254,7 +812,7 @@ allocator::buddy_allocator::Buddy* allocator::buddy_allocator::split_buddy(Buddy
 
 allocator::buddy_allocator::Buddy* allocator::buddy_allocator::find_buddy(Buddy* b, int level) {
     // No buddy exists for the top-level (largest) block
-    if (level == m_buffer.initial_level || b == nullptr) {
+    if (level >= m_buffer.initial_level || b == nullptr) {
         return nullptr;
     }
 
@@ -263,7 +821,7 @@ allocator::buddy_allocator::Buddy* allocator::buddy_allocator::find_buddy(Buddy*
     size_t block_size = get_level_size(level);
 
     // ensure b is inside the managed buffer
-    if (addr < base || addr >= base + m_buffersize) {
+    if (addr < base || addr >= base + m_buffer.size) {
         return nullptr;
     }
 
@@ -278,8 +836,11 @@ allocator::buddy_allocator::Buddy* allocator::buddy_allocator::find_buddy(Buddy*
     // Compute buddy offset by toggling the bit for this block
     uintptr_t buddy_offset = offset ^ block_size;
 
-    // Ensure buddy address stays within the buffer
-    if (buddy_offset >= m_buffersize) {
+    // The merged block must lie entirely inside the buffer. With roots laid out largest first,
+    // any aligned block that fits in the buffer also fits in a single root, so this check alone
+    // stops coalescing from crossing root boundaries (e.g. the 32KB root of a 96KB buffer).
+    uintptr_t merged_offset = offset & ~(2 * block_size - 1);
+    if (merged_offset + 2 * block_size > m_buffer.size) {
         return nullptr;
     }
 
@@ -293,21 +854,15 @@ void allocator::buddy_allocator::try_merge_buddies(Buddy* buddy, int level) {
 
     Buddy* buddyPair = find_buddy(buddy, level);
 
-    // No valid buddy found → cannot merge
-    if (!buddyPair) {
-        return;
-    }
-
-    // If the buddyPair is allocated, we cannot merge
-    if (allocatedBuddies.find(reinterpret_cast<void*>(buddyPair)) != allocatedBuddies.end()) {
+    // No valid buddy found, or the buddyPair is allocated or not free at the same level: the
+    // block is as large as it gets
+    if (!buddyPair || !is_free_at_level(buddyPair, level)) {
+        if (m_purgeOnFree && level >= m_purgeLevel) {
+            purge_block(buddy, level, false);
+        }
         return;
     }
 
-    // If the buddyPair is not at the same level, cannot merge
-    if (buddyPair->level != level) {
-        return; // buddy is not free at the same level
-    }
-
     // Remove both buddies from their current free list
     remove_from_free_list(buddy, level);
     remove_from_free_list(buddyPair, level);
@@ -320,4 +875,249 @@ void allocator::buddy_allocator::try_merge_buddies(Buddy* buddy, int level) {
 
     // Try merging again at the next higher level
     try_merge_buddies(merged_buddy, level + 1);
-}
\ No newline at end of file
+}
+bool allocator::buddy_allocator::is_free_at_level(Buddy* b, int level) const {
+    uintptr_t offset = reinterpret_cast<uintptr_t>(b) - m_buffer.start_address_int;
+    return freeLevels[offset / MIN_CAPACITY] == level;
+}
+
+size_t allocator::buddy_allocator::purge_block(Buddy* buddy, int level, bool immediate) {
+    // The free-list header lives in the first page, which is kept. Blocks at least one page in
+    // size are page aligned because the buffer is.
+    const size_t pageSize = memory_provider::page_size();
+    size_t blockSize = get_level_size(level);
+    if (blockSize < 2 * pageSize) {
+        return 0;
+    }
+
+    // nothing to give back twice, a lazily purged block can still be released for good
+    purge_state target = immediate ? purge_state::released : purge_state::lazy;
+    if (buddy->purged >= target) {
+        return 0;
+    }
+
+    // lazy: the kernel reclaims the pages only under memory pressure, reuse is cheap until then
+    auto* begin = reinterpret_cast<std::byte*>(buddy) + pageSize;
+    size_t released = m_provider->purge(begin, blockSize - pageSize, !immediate);
+    if (released) {
+        buddy->purged = target;
+    }
+    return released;
+}
+
+void allocator::buddy_allocator::release_range(uintptr_t begin, uintptr_t end, bool merge) {
+    // Decompose [begin, end) into maximal aligned blocks, e.g. a 600KB extent at offset 0 is
+    // 512KB + 64KB + 16KB + 8KB and the tail of its 1MB block is 8KB + 32KB + 128KB + 256KB
+    while (begin < end) {
+        int level = m_buffer.initial_level;
+        if (begin != 0) {
+            level = std::min(level, std::countr_zero(begin) - std::countr_zero(MIN_CAPACITY));
+        }
+        while (get_level_size(level) > end - begin) {
+            --level;
+        }
+
+        Buddy* buddy = reinterpret_cast<Buddy*>(m_buffer.start_address_int + begin);
+        add_to_free_list(buddy, level);
+        if (merge) {
+            try_merge_buddies(buddy, level);
+        }
+        begin += get_level_size(level);
+    }
+}
+
+bool allocator::buddy_allocator::try_grow_in_place(uintptr_t offset, size_t oldSize,
+                                                   size_t newSize) {
+    uintptr_t end = offset + newSize;
+
+    // A whole-block (or weighted) allocation must stay at the start of an aligned block, so it
+    // can only grow when it is the lower half at every level it merges through
+    if (m_policy != split_policy::trim_tail && offset % get_power_of_two(newSize) != 0) {
+        return false;
+    }
+
+    if (end > m_buffer.size) {
+        return false;
+    }
+
+    // Everything between the current end and the new end must be covered by free blocks
+    uintptr_t p = offset + oldSize;
+    while (p < end) {
+        int level = freeLevels[p / MIN_CAPACITY];
+        if (level < 0) {
+            return false;
+        }
+        p += get_level_size(level);
+    }
+    uintptr_t claimedEnd = p;
+
+    p = offset + oldSize;
+    while (p < end) {
+        int level = freeLevels[p / MIN_CAPACITY];
+        remove_from_free_list(reinterpret_cast<Buddy*>(m_buffer.start_address_int + p), level);
+        p += get_level_size(level);
+    }
+
+    // The last block may reach past the new end (trimmed extents), keep only what is needed
+    release_range(end, claimedEnd, true);
+    return true;
+}
+
+std::unordered_map<void*, allocator::buddy_allocator::block_info>::iterator
+allocator::buddy_allocator::find_allocation(void* ptr) {
+    // every allocation starts on a minimum block boundary except slab objects, which live
+    // inside one, so a single lookup of the enclosing minimum block finds either
+    uintptr_t offset = reinterpret_cast<uintptr_t>(ptr) - m_buffer.start_address_int;
+    if (offset >= m_buffer.size) {
+        return allocatedBuddies.end();
+    }
+
+    auto* block =
+        reinterpret_cast<void*>(m_buffer.start_address_int + (offset & ~(MIN_CAPACITY - 1)));
+    auto it = allocatedBuddies.find(block);
+    if (it != allocatedBuddies.end() && block != ptr && !it->second.owner) {
+        return allocatedBuddies.end(); // interior pointer of a regular allocation
+    }
+    return it;
+}
+
+void* allocator::buddy_allocator::allocate_small(size_t size, size_t alignment) {
+    int sizeClass = get_slab_class(size, alignment);
+    slab* s = get_partial_slab(sizeClass);
+    if (!s) {
+        handle_allocation_error("No sufficient block available for allocation(" +
+                                std::to_string(get_slab_object_size(sizeClass)) + ")");
+    }
+    return take_slab_object(s, size);
+}
+
+allocator::buddy_allocator::slab* allocator::buddy_allocator::get_partial_slab(int sizeClass) {
+    if (partialSlabs[sizeClass]) {
+        return partialSlabs[sizeClass];
+    }
+
+    // no slab with room left, carve a new one out of a minimum block
+    Buddy* block = acquire_block(0);
+    if (!block) {
+        return nullptr;
+    }
+
+    // both records first, the block goes back when either map cannot grow
+    slab* s = nullptr;
+    try {
+        s = &m_slabs[block];
+        allocatedBuddies.try_emplace(block, block_info{0, MIN_CAPACITY, 0, s});
+    } catch (const std::bad_alloc&) {
+        m_slabs.erase(block);
+        release_block(block, 0);
+        throw;
+    }
+    s->block = block;
+    s->sizeClass = sizeClass;
+    size_t objects = MIN_CAPACITY / get_slab_object_size(sizeClass);
+    s->freeMask = (objects == 64) ? ~std::uint64_t{0} : (std::uint64_t{1} << objects) - 1;
+    slabIndex[(reinterpret_cast<uintptr_t>(block) - m_buffer.start_address_int) / MIN_CAPACITY] = s;
+    push_partial_slab(s);
+    return s;
+}
+
+void allocator::buddy_allocator::free_small(slab* s, void* ptr) {
+    size_t objectSize = get_slab_object_size(s->sizeClass);
+    size_t offset = static_cast<std::byte*>(ptr) - static_cast<std::byte*>(s->block);
+    std::uint64_t bit = std::uint64_t{1} << (offset / objectSize);
+
+    if (offset % objectSize != 0 || (s->freeMask & bit)) {
+        throw std::invalid_argument(
+            m_allocator + ": Pointer not allocated by this allocator or double free detected");
+    }
+
+    // per-object requested sizes are not kept, the slab tracks their sum and frees it evenly
+    size_t requested = s->requested / s->used;
+    s->requested -= requested;
+    m_requestedBytes -= requested;
+    m_allocatedBytes -= objectSize;
+
+    if (s->freeMask == 0) {
+        push_partial_slab(s); // was full, has room again
+    }
+    s->freeMask |= bit;
+
+    if (--s->used == 0) {
+        // empty slab goes back to the buddy tree
+        remove_partial_slab(s);
+        Buddy* block = static_cast<Buddy*>(s->block);
+        allocatedBuddies.erase(block);
+        slabIndex[(reinterpret_cast<uintptr_t>(block) - m_buffer.start_address_int) /
+                  MIN_CAPACITY] = nullptr;
+        m_slabs.erase(block);
+        release_block(block, 0);
+    }
+}
+
+void allocator::buddy_allocator::push_partial_slab(slab* s) {
+    s->prev = nullptr;
+    s->next = partialSlabs[s->sizeClass];
+    if (s->next) {
+        s->next->prev = s;
+    }
+    partialSlabs[s->sizeClass] = s;
+}
+
+void allocator::buddy_allocator::remove_partial_slab(slab* s) {
+    if (s->prev) {
+        s->prev->next = s->next;
+    } else {
+        partialSlabs[s->sizeClass] = s->next;
+    }
+    if (s->next) {
+        s->next->prev = s->prev;
+    }
+    s->prev = s->next = nullptr;
+}
+
+void allocator::buddy_allocator::init_free_bitmaps() {
+    for (int level = 0; level < static_cast<int>(freeBitmaps.size()); ++level) {
+        size_t blocks = (m_buffer.size + get_level_size(level) - 1) / get_level_size(level);
+        size_t words = (blocks + 63) / 64;
+        freeBitmaps[level].words.assign(words, 0);
+        freeBitmaps[level].summary.assign((words + 63) / 64, 0);
+    }
+}
+
+void allocator::buddy_allocator::set_free_bit(Buddy* buddy, int level, bool free) {
+    auto& bitmap = freeBitmaps[level];
+    size_t index = (reinterpret_cast<uintptr_t>(buddy) - m_buffer.start_address_int) >>
+                   std::countr_zero(get_level_size(level));
+    std::uint64_t& word = bitmap.words[index / 64];
+
+    if (free) {
+        word |= std::uint64_t{1} << (index % 64);
+        bitmap.summary[index / 4096] |= std::uint64_t{1} << (index / 64 % 64);
+    } else {
+        word &= ~(std::uint64_t{1} << (index % 64));
+        if (word == 0) {
+            bitmap.summary[index / 4096] &= ~(std::uint64_t{1} << (index / 64 % 64));
+        }
+    }
+}
+
+allocator::buddy_allocator::Buddy* allocator::buddy_allocator::find_free_block(int level,
+                                                                               bool highest) const {
+    const auto& bitmap = freeBitmaps[level];
+    size_t summaries = bitmap.summary.size();
+
+    for (size_t i = 0; i < summaries; ++i) {
+        size_t s = highest ? summaries - 1 - i : i;
+        std::uint64_t summary = bitmap.summary[s];
+        if (summary == 0) {
+            continue;
+        }
+
+        size_t w = s * 64 + (highest ? 63 - std::countl_zero(summary) : std::countr_zero(summary));
+        std::uint64_t word = bitmap.words[w];
+        size_t index = w * 64 + (highest ? 63 - std::countl_zero(word) : std::countr_zero(word));
+        return reinterpret_cast<Buddy*>(m_buffer.start_address_int +
+                                        (index << std::countr_zero(get_level_size(level))));
+    }
+    return nullptr;
+}
@@ -0,0 +1,246 @@
+#include "allocator/concurrent_buddy_allocator.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#if ALLOCATOR_DEBUG
+#define handle_allocation_error(msg) throwAllocationError(m_allocator, msg)
+#else
+#define handle_allocation_error(msg) return nullptr
+#endif
+
+allocator::concurrent_buddy_allocator::concurrent_buddy_allocator(size_t bufferSize,
+                                                                  size_t shardCount,
+                                                                  memory_provider* provider)
+    : m_global(bufferSize, buddy_allocator::split_policy::whole_block,
+               buddy_allocator::buffer_mode::heap, provider) {
+
+    if (shardCount == 0) {
+        shardCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    m_shardCount = shardCount;
+    m_shards = std::make_unique<shard[]>(m_shardCount);
+
+    for (size_t i = 0; i < m_shardCount; ++i) {
+        for (auto& blocks : m_shards[i].blocks) {
+            blocks.reserve(HIGH_WATERMARK);
+        }
+    }
+
+    m_blockStates =
+        std::make_unique<std::uint8_t[]>(m_global.m_buffer.size / buddy_allocator::MIN_CAPACITY);
+}
+
+allocator::concurrent_buddy_allocator::~concurrent_buddy_allocator() {
+    releaseMemory();
+}
+
+void* allocator::concurrent_buddy_allocator::allocate(size_t size, size_t alignment) {
+    auto result = try_allocate(size, alignment);
+    if (!result) {
+        handle_allocation_error(describeAllocationError(result.error(), size));
+    }
+    return *result;
+}
+
+std::expected<void*, allocator::alloc_error>
+allocator::concurrent_buddy_allocator::try_allocate(size_t size,
+                                                    [[maybe_unused]] size_t alignment) noexcept {
+
+    size_t actualSize = buddy_allocator::get_power_of_two(size);
+    int level = buddy_allocator::get_level(actualSize);
+
+    // large blocks skip the caches and go straight to the shared tree
+    if (level >= CACHED_LEVELS) {
+        std::expected<void*, alloc_error> result;
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            if (attempt == 1) {
+                // small blocks parked in the caches keep the larger ones split, merge them back
+                drain_all_shards();
+            }
+
+            std::lock_guard<std::mutex> guard(m_globalLock);
+            result = m_global.try_allocate(size);
+            if (result || result.error() != alloc_error::out_of_memory) {
+                break;
+            }
+        }
+        if (result) {
+            m_allocatedSize.fetch_add(actualSize, std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    void* ptr = nullptr;
+    try { // a cache that cannot grow its block list counts as exhausted
+        for (int attempt = 0; attempt < 2 && !ptr; ++attempt) {
+            if (attempt == 1) {
+                // the tree is exhausted, but other CPUs may be holding the memory in their caches
+                drain_all_shards();
+            }
+
+            shard& s = current_shard();
+            std::lock_guard<std::mutex> guard(s.lock);
+            auto& blocks = s.blocks[level];
+            if (!blocks.empty() || refill(s, level)) {
+                ptr = blocks.back();
+                blocks.pop_back();
+            }
+        }
+    } catch (const std::bad_alloc&) {
+    }
+
+    if (!ptr) {
+        return std::unexpected(alloc_error::out_of_memory);
+    }
+
+    block_state(ptr) = static_cast<std::uint8_t>(level + 1);
+    m_allocatedSize.fetch_add(actualSize, std::memory_order_relaxed);
+    return ptr;
+}
+
+void allocator::concurrent_buddy_allocator::deallocate(void* ptr) {
+    if (!ptr) {
+        throw std::invalid_argument(m_allocator + ": Attempted to deallocate a null pointer");
+    }
+
+    if (!m_blockStates) {
+        throw std::invalid_argument(m_allocator + ": Allocator has released its memory");
+    }
+
+    uintptr_t offset = reinterpret_cast<uintptr_t>(ptr) - m_global.m_buffer.start_address_int;
+    bool cachedBlock = offset < m_global.m_buffer.size &&
+                       offset % buddy_allocator::MIN_CAPACITY == 0 && block_state(ptr) != 0;
+
+    if (cachedBlock) {
+        std::uint8_t& state = block_state(ptr);
+        if (state & IN_CACHE) {
+            throw std::invalid_argument(m_allocator + ": double free detected");
+        }
+
+        int level = state - 1;
+        state |= IN_CACHE;
+        m_allocatedSize.fetch_sub(buddy_allocator::get_level_size(level),
+                                  std::memory_order_relaxed);
+
+        shard& s = current_shard();
+        std::lock_guard<std::mutex> guard(s.lock);
+        s.blocks[level].push_back(ptr);
+        if (s.blocks[level].size() >= HIGH_WATERMARK) {
+            drain(s, level, HIGH_WATERMARK / 2);
+        }
+        return;
+    }
+
+    // not handed out by a cache, the tree validates and frees it
+    std::lock_guard<std::mutex> guard(m_globalLock);
+    auto it = m_global.allocatedBuddies.find(ptr);
+    size_t size = (it != m_global.allocatedBuddies.end()) ? it->second.size : 0;
+    m_global.deallocate(ptr);
+    m_allocatedSize.fetch_sub(size, std::memory_order_relaxed);
+}
+
+size_t allocator::concurrent_buddy_allocator::getAllocatedSize() const {
+    return m_allocatedSize.load(std::memory_order_relaxed);
+}
+
+void allocator::concurrent_buddy_allocator::reset() {
+    std::vector<std::unique_lock<std::mutex>> guards;
+    for (size_t i = 0; i < m_shardCount; ++i) {
+        guards.emplace_back(m_shards[i].lock);
+        for (auto& blocks : m_shards[i].blocks) {
+            blocks.clear();
+        }
+    }
+
+    std::lock_guard<std::mutex> guard(m_globalLock);
+    m_global.reset();
+    m_blockStates =
+        std::make_unique<std::uint8_t[]>(m_global.m_buffer.size / buddy_allocator::MIN_CAPACITY);
+    m_allocatedSize.store(0, std::memory_order_relaxed);
+}
+
+void allocator::concurrent_buddy_allocator::releaseMemory() {
+    std::vector<std::unique_lock<std::mutex>> guards;
+    for (size_t i = 0; i < m_shardCount; ++i) {
+        guards.emplace_back(m_shards[i].lock);
+        for (auto& blocks : m_shards[i].blocks) {
+            blocks.clear();
+        }
+    }
+
+    std::lock_guard<std::mutex> guard(m_globalLock);
+    m_global.releaseMemory();
+    m_blockStates.reset();
+    m_allocatedSize.store(0, std::memory_order_relaxed);
+}
+
+void allocator::concurrent_buddy_allocator::setAllocatorName(std::string_view name) {
+    m_allocator = name;
+    m_global.setAllocatorName(name);
+}
+
+allocator::concurrent_buddy_allocator::shard&
+allocator::concurrent_buddy_allocator::current_shard() {
+#if defined(__linux__)
+    // per-CPU: a thread migrating between the call and the lock only costs some contention
+    int cpu = sched_getcpu();
+    if (cpu >= 0) {
+        return m_shards[static_cast<size_t>(cpu) % m_shardCount];
+    }
+#endif
+    // fall back to spreading threads round-robin over the shards
+    static std::atomic<size_t> nextThread{0};
+    thread_local size_t threadIndex = nextThread.fetch_add(1, std::memory_order_relaxed);
+    return m_shards[threadIndex % m_shardCount];
+}
+
+bool allocator::concurrent_buddy_allocator::refill(shard& s, int level) {
+    auto& blocks = s.blocks[level];
+
+    // take a whole batch under one acquisition of the tree lock. Cached blocks are removed from
+    // the tree's free lists but never recorded as allocations there, the shard owns them
+    std::lock_guard<std::mutex> guard(m_globalLock);
+    for (size_t i = 0; i < BATCH_SIZE; ++i) {
+        auto* block = m_global.take_free_block(level);
+        if (!block) {
+            break;
+        }
+        block_state(block) = static_cast<std::uint8_t>((level + 1) | IN_CACHE);
+        blocks.push_back(block);
+    }
+    return !blocks.empty();
+}
+
+void allocator::concurrent_buddy_allocator::drain(shard& s, int level, size_t count) {
+    auto& blocks = s.blocks[level];
+    count = std::min(count, blocks.size());
+
+    // return the oldest (coldest) blocks, the most recently freed ones stay cached
+    std::lock_guard<std::mutex> guard(m_globalLock);
+    for (size_t i = 0; i < count; ++i) {
+        auto* block = static_cast<buddy_allocator::Buddy*>(blocks[i]);
+        block_state(block) = 0;
+        m_global.add_to_free_list(block, level);
+        m_global.try_merge_buddies(block, level);
+    }
+    blocks.erase(blocks.begin(), blocks.begin() + static_cast<std::ptrdiff_t>(count));
+}
+
+void allocator::concurrent_buddy_allocator::drain_all_shards() {
+    for (size_t i = 0; i < m_shardCount; ++i) {
+        std::lock_guard<std::mutex> guard(m_shards[i].lock);
+        for (int level = 0; level < CACHED_LEVELS; ++level) {
+            drain(m_shards[i], level, m_shards[i].blocks[level].size());
+        }
+    }
+}
+
+std::uint8_t& allocator::concurrent_buddy_allocator::block_state(void* ptr) {
+    uintptr_t offset = reinterpret_cast<uintptr_t>(ptr) - m_global.m_buffer.start_address_int;
+    return m_blockStates[offset / buddy_allocator::MIN_CAPACITY];
+}
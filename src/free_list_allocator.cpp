@@ -0,0 +1,321 @@
+#include "allocator/free_list_allocator.hpp"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#if ALLOCATOR_DEBUG
+#define handle_allocation_error(msg) throwAllocationError(m_allocator, msg)
+#else
+#define handle_allocation_error(msg) return nullptr
+#endif
+
+namespace {
+constexpr size_t npos = std::numeric_limits<size_t>::max();
+}
+
+allocator::free_list_allocator::free_list_allocator(size_t bufferSize, fit_policy policy,
+                                                    memory_provider* provider)
+    : m_policy(policy), m_provider(provider ? provider : default_memory_provider()) {
+    if (bufferSize < MIN_CAPACITY || bufferSize > MAX_CAPACITY) {
+        throw std::invalid_argument(m_allocator + ": Buffer size must be between " +
+                                    std::to_string(MIN_CAPACITY / 1024) + "KB and " +
+                                    std::to_string(MAX_CAPACITY / (1024 * 1024)) + "MB");
+    }
+
+    m_bufferSize = getAlignedSize(bufferSize, BLOCK_ALIGNMENT);
+    allocate_new_buffer();
+}
+
+allocator::free_list_allocator::~free_list_allocator() {
+    releaseMemory();
+}
+
+void* allocator::free_list_allocator::allocate(size_t size, size_t alignment) {
+    auto result = try_allocate(size, alignment);
+    if (!result) {
+        handle_allocation_error(describeAllocationError(result.error(), size));
+    }
+    return *result;
+}
+
+std::expected<void*, allocator::alloc_error>
+allocator::free_list_allocator::try_allocate(size_t size, size_t alignment) noexcept {
+    if (!m_ownsMemory) {
+        return std::unexpected(alloc_error::no_memory);
+    }
+
+    if (alignment != 0 && !isAlignmentPowerOfTwo(alignment)) {
+        return std::unexpected(alloc_error::invalid_alignment);
+    }
+
+    if (size > m_bufferSize) {
+        return std::unexpected(alloc_error::size_too_large);
+    }
+
+    size_t needed = std::max(getAlignedSize(size + 2 * TAG_SIZE, BLOCK_ALIGNMENT), MIN_BLOCK_SIZE);
+    alignment = std::max(alignment, BLOCK_ALIGNMENT);
+
+    size_t offset = 0;
+    std::byte* block = find_free_block(needed, alignment, offset);
+    if (!block) {
+        return std::unexpected(alloc_error::out_of_memory);
+    }
+
+    remove_free_block(block);
+    size_t blockSize = block_size(block);
+
+    // the gap in front of an over-aligned payload stays free, fit_offset made it large enough
+    if (offset != 0) {
+        write_tags(block, offset, false);
+        insert_free_block(block);
+        block += offset;
+        blockSize -= offset;
+    }
+
+    // give the tail back when it can hold a block of its own
+    if (blockSize - needed >= MIN_BLOCK_SIZE) {
+        std::byte* remaining = block + needed;
+        write_tags(remaining, blockSize - needed, false);
+        insert_free_block(remaining);
+        if (m_policy == fit_policy::next_fit) {
+            m_rover = remaining;
+        }
+        blockSize = needed;
+    }
+
+    write_tags(block, blockSize, true);
+
+    m_lastAllocation = blockSize - 2 * TAG_SIZE;
+    m_allocatedSize += m_lastAllocation;
+    return block + TAG_SIZE;
+}
+
+void allocator::free_list_allocator::deallocate(void* ptr) {
+    if (!ptr) {
+        throw std::invalid_argument(m_allocator + ": Attempted to deallocate a null pointer");
+    }
+
+    if (!m_ownsMemory) {
+        throw std::invalid_argument(m_allocator + ": Allocator does not hold any memory on heap");
+    }
+
+    // the payload must be on the 16 byte grid between the prologue and the epilogue
+    std::byte* start = m_memory.get();
+    std::byte* end = start + m_bufferSize - TAG_SIZE;
+    auto* p = static_cast<std::byte*>(ptr);
+    if (p < start + 2 * TAG_SIZE || p >= end ||
+        reinterpret_cast<uintptr_t>(p) % BLOCK_ALIGNMENT != 0) {
+        throw std::invalid_argument(m_allocator + ": Pointer not allocated by this allocator");
+    }
+
+    std::byte* block = p - TAG_SIZE;
+    if (!is_allocated(block)) {
+        throw std::invalid_argument(m_allocator + ": double free detected");
+    }
+
+    // an interior pointer reads payload bytes as a header, the matching footer rules that out
+    size_t size = block_size(block);
+    if (size < MIN_BLOCK_SIZE || size % BLOCK_ALIGNMENT != 0 ||
+        size > static_cast<size_t>(end - block) || footer(block) != header(block)) {
+        throw std::invalid_argument(m_allocator + ": Pointer not allocated by this allocator");
+    }
+
+    m_allocatedSize -= size - 2 * TAG_SIZE;
+
+    // immediate coalescing: the previous footer and the next header sit right beside the block
+    size_t prevTag = *reinterpret_cast<size_t*>(block - TAG_SIZE);
+    if (!(prevTag & ALLOCATED)) {
+        block -= prevTag;
+        remove_free_block(block);
+        size += prevTag;
+    }
+
+    std::byte* next = block + size;
+    if (!is_allocated(next)) {
+        remove_free_block(next);
+        size += block_size(next);
+    }
+
+    write_tags(block, size, false);
+    insert_free_block(block);
+}
+
+size_t allocator::free_list_allocator::getAllocatedSize() const {
+    return m_allocatedSize;
+}
+
+size_t allocator::free_list_allocator::getObjectSize() const {
+    return m_lastAllocation;
+}
+
+void allocator::free_list_allocator::reset() {
+    if (m_ownsMemory) {
+        init_free_list();
+    } else {
+        allocate_new_buffer();
+    }
+}
+
+void allocator::free_list_allocator::releaseMemory() {
+    m_memory.reset();
+    m_ownsMemory = false;
+    m_freeHead = nullptr;
+    m_rover = nullptr;
+    m_freeBlockCount = 0;
+    m_allocatedSize = 0;
+    m_lastAllocation = 0;
+}
+
+void allocator::free_list_allocator::setAllocatorName(std::string_view name) {
+    m_allocator = name;
+}
+
+size_t allocator::free_list_allocator::getFreeBlockCount() const {
+    return m_freeBlockCount;
+}
+
+size_t& allocator::free_list_allocator::header(std::byte* block) {
+    return *reinterpret_cast<size_t*>(block);
+}
+
+size_t& allocator::free_list_allocator::footer(std::byte* block) {
+    return *reinterpret_cast<size_t*>(block + block_size(block) - TAG_SIZE);
+}
+
+size_t allocator::free_list_allocator::block_size(std::byte* block) {
+    return header(block) & ~ALLOCATED;
+}
+
+bool allocator::free_list_allocator::is_allocated(std::byte* block) {
+    return header(block) & ALLOCATED;
+}
+
+void allocator::free_list_allocator::write_tags(std::byte* block, size_t size, bool allocated) {
+    header(block) = size | (allocated ? ALLOCATED : 0);
+    footer(block) = header(block);
+}
+
+allocator::free_list_allocator::free_links&
+allocator::free_list_allocator::links(std::byte* block) {
+    return *reinterpret_cast<free_links*>(block + TAG_SIZE);
+}
+
+void allocator::free_list_allocator::insert_free_block(std::byte* block) {
+    // LIFO: freeing stays O(1), address order is left to the boundary tags
+    free_links& l = links(block);
+    l.next = m_freeHead;
+    l.prev = nullptr;
+    if (m_freeHead) {
+        links(m_freeHead).prev = block;
+    }
+    m_freeHead = block;
+    ++m_freeBlockCount;
+}
+
+void allocator::free_list_allocator::remove_free_block(std::byte* block) {
+    free_links& l = links(block);
+    if (l.prev) {
+        links(l.prev).next = l.next;
+    } else {
+        m_freeHead = l.next;
+    }
+    if (l.next) {
+        links(l.next).prev = l.prev;
+    }
+    if (m_rover == block) {
+        m_rover = l.next;
+    }
+    --m_freeBlockCount;
+}
+
+size_t allocator::free_list_allocator::fit_offset(std::byte* block, size_t size,
+                                                  size_t alignment) {
+    size_t blockSize = block_size(block);
+    if (alignment <= BLOCK_ALIGNMENT) {
+        return blockSize >= size ? 0 : npos;
+    }
+
+    // a leading gap too small to be a free block is pushed to the next aligned address
+    auto payload = reinterpret_cast<uintptr_t>(block + TAG_SIZE);
+    size_t gap = getAlignedSize(payload, alignment) - payload;
+    if (gap != 0 && gap < MIN_BLOCK_SIZE) {
+        gap = getAlignedSize(payload + MIN_BLOCK_SIZE, alignment) - payload;
+    }
+    return gap + size <= blockSize ? gap : npos;
+}
+
+std::byte* allocator::free_list_allocator::find_free_block(size_t size, size_t alignment,
+                                                           size_t& offset) {
+    if (!m_freeHead) {
+        return nullptr;
+    }
+
+    switch (m_policy) {
+    case fit_policy::first_fit:
+        for (std::byte* block = m_freeHead; block; block = links(block).next) {
+            if ((offset = fit_offset(block, size, alignment)) != npos) {
+                return block;
+            }
+        }
+        return nullptr;
+
+    case fit_policy::next_fit: {
+        // one lap around the list starting at the rover
+        std::byte* first = m_rover ? m_rover : m_freeHead;
+        std::byte* block = first;
+        do {
+            if ((offset = fit_offset(block, size, alignment)) != npos) {
+                m_rover = block;
+                return block;
+            }
+            block = links(block).next ? links(block).next : m_freeHead;
+        } while (block != first);
+        return nullptr;
+    }
+
+    default: {
+        std::byte* best = nullptr;
+        size_t bestSize = npos;
+        for (std::byte* block = m_freeHead; block; block = links(block).next) {
+            size_t blockOffset = fit_offset(block, size, alignment);
+            if (blockOffset == npos || block_size(block) >= bestSize) {
+                continue;
+            }
+            best = block;
+            bestSize = block_size(block);
+            offset = blockOffset;
+            if (bestSize == size + blockOffset) {
+                break; // exact fit, nothing better to find
+            }
+        }
+        return best;
+    }
+    }
+}
+
+void allocator::free_list_allocator::allocate_new_buffer() {
+    m_memory = acquire_buffer(*m_provider, m_bufferSize, alignof(std::max_align_t));
+    if (!m_memory) {
+        throw std::bad_alloc();
+    }
+    m_ownsMemory = true;
+    init_free_list();
+}
+
+void allocator::free_list_allocator::init_free_list() {
+    m_freeHead = nullptr;
+    m_rover = nullptr;
+    m_freeBlockCount = 0;
+    m_allocatedSize = 0;
+    m_lastAllocation = 0;
+
+    // An allocated zero-size footer before the first block and header after the last one stop
+    // coalescing at the buffer ends. The first header sits 8 bytes in, so payloads land on 16.
+    std::byte* start = m_memory.get();
+    header(start) = ALLOCATED;
+    header(start + m_bufferSize - TAG_SIZE) = ALLOCATED;
+
+    std::byte* block = start + TAG_SIZE;
+    write_tags(block, m_bufferSize - 2 * TAG_SIZE, false);
+    insert_free_block(block);
+}
@@ -0,0 +1,257 @@
+#include "allocator/memory_provider.hpp"
+#include "allocator/allocator_interface.hpp"
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define ALLOCATOR_HAS_MMAP 1
+#endif
+
+#if defined(__linux__) && defined(ALLOCATOR_HAS_MMAP)
+#include <fcntl.h>
+#define ALLOCATOR_HAS_MEMFD 1
+#endif
+
+namespace {
+
+size_t align_up(size_t size, size_t alignment) {
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+#ifdef ALLOCATOR_HAS_MMAP
+// Maps size bytes at an address aligned to alignment. mmap only guarantees page alignment, a
+// larger one is had by mapping alignment more and unmapping the misaligned head and the tail.
+// Memory of fd is mapped shared over an anonymous reservation, fd -1 maps anonymous memory.
+void* map_aligned(size_t size, size_t alignment, int fd) {
+    size_t pageSize = allocator::memory_provider::page_size();
+    size_t slack = alignment > pageSize ? alignment : 0;
+    int flags = fd < 0 ? MAP_PRIVATE | MAP_ANONYMOUS : MAP_SHARED;
+    if (slack == 0) {
+        void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, fd, 0);
+        return mapping == MAP_FAILED ? nullptr : mapping;
+    }
+
+    void* reserved =
+        mmap(nullptr, size + slack, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (reserved == MAP_FAILED) {
+        return nullptr;
+    }
+
+    auto* base = static_cast<std::byte*>(reserved);
+    auto* aligned = reinterpret_cast<std::byte*>(
+        align_up(reinterpret_cast<uintptr_t>(base), alignment));
+    if (aligned != base) {
+        munmap(base, aligned - base);
+    }
+    munmap(aligned + size, base + size + slack - (aligned + size));
+
+    void* mapping = mmap(aligned, size, PROT_READ | PROT_WRITE, flags | MAP_FIXED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        munmap(aligned, size);
+        return nullptr;
+    }
+    return mapping;
+}
+#endif
+
+} // namespace
+
+size_t allocator::memory_provider::page_size() noexcept {
+#ifdef ALLOCATOR_HAS_MMAP
+    static const auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return pageSize;
+#else
+    return 4096;
+#endif
+}
+
+void* allocator::new_delete_provider::acquire(size_t size, size_t alignment) noexcept {
+    // uninitialized: every allocator writes its metadata before handing memory out, zeroing
+    // here would fault in every page of a large buffer at construction
+    return ::operator new(size, std::align_val_t{alignment}, std::nothrow);
+}
+
+void allocator::new_delete_provider::release(void* ptr, [[maybe_unused]] size_t size,
+                                             size_t alignment) noexcept {
+    ::operator delete(ptr, std::align_val_t{alignment});
+}
+
+size_t allocator::mmap_provider::mapped_size(size_t size) const noexcept {
+    return align_up(size, m_pages == pages::huge ? HUGE_PAGE_SIZE : page_size());
+}
+
+void* allocator::mmap_provider::acquire([[maybe_unused]] size_t size,
+                                        [[maybe_unused]] size_t alignment) noexcept {
+#ifdef ALLOCATOR_HAS_MMAP
+    size_t length = mapped_size(size);
+    if (m_pages == pages::normal) {
+        return map_aligned(length, alignment, -1);
+    }
+
+#ifdef MAP_HUGETLB
+    // needs pages reserved in /proc/sys/vm/nr_hugepages, most systems have none
+    if (alignment <= HUGE_PAGE_SIZE) {
+        void* mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (mapping != MAP_FAILED) {
+            return mapping;
+        }
+    }
+#endif
+    // transparent huge pages need a 2MB aligned range to back it with whole huge pages
+    void* mapping = map_aligned(length, std::max(alignment, HUGE_PAGE_SIZE), -1);
+#ifdef MADV_HUGEPAGE
+    if (mapping) {
+        madvise(mapping, length, MADV_HUGEPAGE);
+    }
+#endif
+    return mapping;
+#else
+    return nullptr;
+#endif
+}
+
+void allocator::mmap_provider::release([[maybe_unused]] void* ptr, [[maybe_unused]] size_t size,
+                                       [[maybe_unused]] size_t alignment) noexcept {
+#ifdef ALLOCATOR_HAS_MMAP
+    munmap(ptr, mapped_size(size));
+#endif
+}
+
+size_t allocator::mmap_provider::purge([[maybe_unused]] void* ptr, [[maybe_unused]] size_t size,
+                                       [[maybe_unused]] bool lazy) noexcept {
+#ifdef ALLOCATOR_HAS_MMAP
+#ifdef MADV_FREE
+    // lazy: the kernel reclaims the pages only under memory pressure, reuse is cheap until then
+    if (lazy && madvise(ptr, size, MADV_FREE) == 0) {
+        return size;
+    }
+#endif
+    if (madvise(ptr, size, MADV_DONTNEED) == 0) {
+        return size;
+    }
+#endif
+    return 0;
+}
+
+allocator::memfd_provider::~memfd_provider() {
+#ifdef ALLOCATOR_HAS_MEMFD
+    // ranges still acquired belong to allocators that outlived the provider, their mappings
+    // stay valid without the descriptors
+    for (auto& [ptr, fd] : m_files) {
+        close(fd);
+    }
+#endif
+}
+
+void* allocator::memfd_provider::acquire([[maybe_unused]] size_t size,
+                                         [[maybe_unused]] size_t alignment) noexcept {
+#ifdef ALLOCATOR_HAS_MEMFD
+    int fd = memfd_create(m_name.c_str(), MFD_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    size_t length = align_up(size, page_size());
+    void* mapping = ftruncate(fd, static_cast<off_t>(length)) == 0
+                        ? map_aligned(length, alignment, fd)
+                        : nullptr;
+    if (mapping) {
+        try {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_files.emplace(mapping, fd);
+            return mapping;
+        } catch (const std::bad_alloc&) {
+            munmap(mapping, length);
+        }
+    }
+    close(fd);
+#endif
+    return nullptr;
+}
+
+void allocator::memfd_provider::release([[maybe_unused]] void* ptr, [[maybe_unused]] size_t size,
+                                        [[maybe_unused]] size_t alignment) noexcept {
+#ifdef ALLOCATOR_HAS_MEMFD
+    munmap(ptr, align_up(size, page_size()));
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (auto it = m_files.find(ptr); it != m_files.end()) {
+        close(it->second);
+        m_files.erase(it);
+    }
+#endif
+}
+
+size_t allocator::memfd_provider::purge([[maybe_unused]] void* ptr, [[maybe_unused]] size_t size,
+                                        [[maybe_unused]] bool lazy) noexcept {
+#if defined(ALLOCATOR_HAS_MEMFD) && defined(MADV_REMOVE)
+    // MADV_DONTNEED only drops the mapping of shared pages, the file keeps them
+    if (madvise(ptr, size, MADV_REMOVE) == 0) {
+        return size;
+    }
+#endif
+    return 0;
+}
+
+int allocator::memfd_provider::getFileDescriptor(void* ptr) const {
+    std::lock_guard<std::mutex> lock(m_lock);
+    auto it = m_files.find(ptr);
+    return it != m_files.end() ? it->second : -1;
+}
+
+allocator::buffer_provider::buffer_provider(void* buffer, size_t size)
+    : m_buffer(static_cast<std::byte*>(buffer)), m_size(size) {
+    if (!buffer) {
+        throw std::invalid_argument("buffer_provider: Buffer must not be null");
+    }
+}
+
+void* allocator::buffer_provider::acquire(size_t size, size_t alignment) noexcept {
+    auto base = reinterpret_cast<uintptr_t>(m_buffer);
+    size_t offset = align_up(base + m_used, alignment) - base;
+    if (offset > m_size || size > m_size - offset) {
+        return nullptr;
+    }
+    m_used = offset + size;
+    return m_buffer + offset;
+}
+
+void allocator::buffer_provider::release(void* ptr, size_t size,
+                                         [[maybe_unused]] size_t alignment) noexcept {
+    // the alignment padding in front of the range stays used until reset()
+    auto* p = static_cast<std::byte*>(ptr);
+    if (p + size == m_buffer + m_used) {
+        m_used = p - m_buffer;
+    }
+}
+
+void* allocator::upstream_provider::acquire(size_t size, size_t alignment) noexcept {
+    auto result = m_upstream.try_allocate(size, alignment);
+    if (!result) {
+        return nullptr;
+    }
+
+    // pool blocks and stack chunks follow their own alignment, not the one asked for
+    if (reinterpret_cast<uintptr_t>(*result) % alignment != 0) {
+        release(*result, size, alignment);
+        return nullptr;
+    }
+    return *result;
+}
+
+void allocator::upstream_provider::release(void* ptr, size_t size, size_t alignment) noexcept {
+    try {
+        m_upstream.deallocate(ptr, size, alignment);
+    } catch (const std::exception&) {
+        // the upstream allocator was reset or released under the range, nothing left to free
+    }
+}
+
+allocator::memory_provider* allocator::default_memory_provider() noexcept {
+    static new_delete_provider provider;
+    return &provider;
+}
@@ -1,4 +1,5 @@
-#include "allocator/Pool_allocator.hpp"
+#include "allocator/pool_allocator.hpp"
+#include <new>
 #include <stdexcept>
 
 #if ALLOCATOR_DEBUG
@@ -8,8 +9,10 @@
 #endif
 
 allocator::pool_allocator::pool_allocator(size_t blockSize, size_t initial_capacity,
-                                          size_t alignment, size_t maxPools)
-    : m_blockCount(initial_capacity) {
+                                          size_t alignment, size_t maxPools,
+                                          memory_provider* provider)
+    : m_blockCount(initial_capacity),
+      m_provider(provider ? provider : default_memory_provider()) {
 
     if (blockSize == 0 || initial_capacity == 0) {
         throw std::invalid_argument(m_allocator +
@@ -54,44 +57,78 @@ allocator::pool_allocator::~pool_allocator() {
     releaseMemory();
 }
 
-void* allocator::pool_allocator::allocate(size_t size, [[maybe_unused]] size_t alignment) {
+// the moved-from side keeps the configuration and is left without pools by the swap
+allocator::pool_allocator::pool_allocator(pool_allocator&& other) noexcept
+    : m_blockSize(other.m_blockSize), m_blockCount(other.m_blockCount),
+      m_alignment(other.m_alignment), m_poolSize(other.m_poolSize), m_maxPools(other.m_maxPools),
+      m_provider(other.m_provider) {
+    swap(other);
+}
 
-    // This function exists solely to support polymorphism.
-    // The actual memory allocation is handled by allocate() without arguments,
-    // which simply returns a free block.
+allocator::pool_allocator& allocator::pool_allocator::operator=(pool_allocator&& other) noexcept {
+    if (this != &other) {
+        swap(other);
+        other.releaseMemory(); // our old pools go with the moved-from side
+    }
+    return *this;
+}
 
-    if (size > m_blockSize) {
-        handle_allocation_error("Requested size exceeds block size");
+void allocator::pool_allocator::swap(pool_allocator& other) noexcept {
+    using std::swap;
+    swap(m_blockSize, other.m_blockSize);
+    swap(m_blockCount, other.m_blockCount);
+    swap(m_alignment, other.m_alignment);
+    swap(m_poolSize, other.m_poolSize);
+    swap(pools, other.pools);
+    swap(m_currentPool, other.m_currentPool);
+    swap(m_ownsMemory, other.m_ownsMemory);
+    swap(m_maxPools, other.m_maxPools);
+    swap(m_provider, other.m_provider);
+    swap(m_allocator, other.m_allocator);
+}
+
+void* allocator::pool_allocator::allocate_slow(size_t size) {
+    auto result = try_allocate_slow(size);
+    if (!result) {
+        handle_allocation_error(describeAllocationError(result.error(), size));
     }
-    return allocate();
+    return *result;
 }
 
-void* allocator::pool_allocator::allocate() {
-    if (!m_ownsMemory) {
-        handle_allocation_error("Allocator has released its memory");
+std::expected<void*, allocator::alloc_error>
+allocator::pool_allocator::try_allocate_slow(size_t size) noexcept {
+    if (size > m_blockSize) {
+        return std::unexpected(alloc_error::size_too_large);
     }
 
-    for (auto& p : pools) {
-        if (p.free_list_head != nullptr) {
-            void* block = p.free_list_head;
-            p.free_list_head = *reinterpret_cast<void**>(block);
-            p.allocated_count++;
-            p.free_count--;
+    if (!m_ownsMemory) {
+        return std::unexpected(alloc_error::no_memory);
+    }
 
-            return block;
+    // the current pool is exhausted, move on to the first one with a free block
+    for (size_t i = 0; i < pools.size(); ++i) {
+        if (pools[i].has_free_block()) {
+            m_currentPool = i;
+            return pop_current();
         }
     }
 
-    allocate_new_pool();
-    return allocate();
+    if (auto added = add_pool(); !added) {
+        return std::unexpected(added.error());
+    }
+    m_currentPool = pools.size() - 1;
+    return pop_current();
 }
 
-void allocator::pool_allocator::deallocate(void* ptr) {
-    if (!ptr) {
+template <allocator::check_policy Policy>
+void allocator::pool_allocator::deallocate_slow(void* ptr) {
+    constexpr bool checked = Policy != check_policy::unchecked;
+
+    if (checked && !ptr) {
         throw std::invalid_argument(m_allocator + ": Attempted to deallocate a null pointer");
     }
 
-    if (!m_ownsMemory) {
+    if (checked && !m_ownsMemory) {
         throw std::invalid_argument(m_allocator + ": Allocator does not hold any memory on heap");
     }
 
@@ -104,21 +141,23 @@ void allocator::pool_allocator::deallocate(void* ptr) {
         if (p >= start && p < end) {
 
             std::uintptr_t offset = p - start;
-            if (offset % m_blockSize != 0) {
+            if (checked && offset % m_blockSize != 0) {
                 throw std::runtime_error(
                     "Pointer is inside pool memory but does not point to the start of a block");
             }
 
-// Optional: debug-only double-free detection.
-// This is O(n) but invaluable during development.
-#ifndef ALLOCATOR_DEBUG
-            for (void* walk = pool.free_list_head; walk != nullptr;
-                 walk = *reinterpret_cast<void**>(walk)) {
-                if (walk == ptr) {
-                    throw std::runtime_error("Double free detected");
+            // O(n) in the free blocks of the pool, but invaluable during development
+            if constexpr (Policy == check_policy::paranoid) {
+                if (offset >= pool.carved) {
+                    throw std::runtime_error("Double free detected"); // never handed out
+                }
+                for (void* walk = pool.free_list_head; walk != nullptr;
+                     walk = *reinterpret_cast<void**>(walk)) {
+                    if (walk == ptr) {
+                        throw std::runtime_error("Double free detected");
+                    }
                 }
             }
-#endif
 
             // Put the block back on the free list
             *reinterpret_cast<void**>(ptr) = pool.free_list_head;
@@ -132,10 +171,17 @@ void allocator::pool_allocator::deallocate(void* ptr) {
         }
     }
 
-    throw std::runtime_error(m_allocator +
-                             ": Pointer does not belong to any pools inside this allocator");
+    if (checked) {
+        throw std::runtime_error(m_allocator +
+                                 ": Pointer does not belong to any pools inside this allocator");
+    }
 }
 
+// the inline deallocate instantiates the slow path of each policy
+template void allocator::pool_allocator::deallocate_slow<allocator::check_policy::unchecked>(void*);
+template void allocator::pool_allocator::deallocate_slow<allocator::check_policy::checked>(void*);
+template void allocator::pool_allocator::deallocate_slow<allocator::check_policy::paranoid>(void*);
+
 size_t allocator::pool_allocator::getAllocatedSize() const {
     size_t totalAllocated = 0;
     for (const auto& p : pools) {
@@ -153,15 +199,13 @@ void allocator::pool_allocator::reset() {
         while (pools.size() > 1) {
             pools.pop_back();
         }
+        m_currentPool = 0;
 
+        // every block is untouched again, the old free list is simply dropped
         auto& last_pool = pools.front();
-        for (size_t i = 0; i < m_blockCount; ++i) {
-            void* block = last_pool.memory.get() + i * m_blockSize;
-            *reinterpret_cast<void**>(block) = last_pool.free_list_head;
-            last_pool.free_list_head = block;
-            last_pool.free_count++;
-        }
-
+        last_pool.free_list_head = nullptr;
+        last_pool.carved = 0;
+        last_pool.free_count = m_blockCount;
         last_pool.allocated_count = 0;
     } else {
         allocate_new_pool();
@@ -170,42 +214,41 @@ void allocator::pool_allocator::reset() {
 
 void allocator::pool_allocator::releaseMemory() {
     pools.clear();
+    m_currentPool = 0;
     m_ownsMemory = false;
 }
 
 void allocator::pool_allocator::allocate_new_pool() {
+    if (auto added = add_pool(); !added) {
+        throwAllocationError(m_allocator, describeAllocationError(added.error(), m_poolSize));
+    }
+}
 
-    if (m_ownsMemory) {
-
-        if (m_maxPools == 0) {
-            throwAllocationError(m_allocator,
-                                 "No more pools can be allocated as maxPools is set to 0");
-        }
-
-        if (m_poolSize * (pools.size() + 1) > MAX_CAPACITY) {
-            throwAllocationError(m_allocator, "Exceeds maximum capacity(64 MB)");
-        }
+std::expected<void, allocator::alloc_error> allocator::pool_allocator::add_pool() noexcept {
 
-        if ((pools.size() + 1) > m_maxPools) {
-            throwAllocationError(m_allocator,
-                                 "Exceeds maximum pool count : " + std::to_string(m_maxPools));
+    if (m_ownsMemory) {
+        // maxPools of 0 would forbid any growth, the total is capped at 64 MB
+        if (m_maxPools == 0 || m_poolSize * (pools.size() + 1) > MAX_CAPACITY ||
+            (pools.size() + 1) > m_maxPools) {
+            return std::unexpected(alloc_error::capacity_exceeded);
         }
     }
 
     pool new_pool;
-    new_pool.memory = std::make_unique<std::byte[]>(m_poolSize);
-    m_ownsMemory = true;
+    new_pool.memory = acquire_buffer(*m_provider, m_poolSize, alignof(std::max_align_t));
+    if (!new_pool.memory) {
+        return std::unexpected(alloc_error::out_of_memory);
+    }
     new_pool.size = m_poolSize;
+    new_pool.free_count = m_blockCount; // all carved on demand by pop_current()
 
-    // Initialize free list
-    for (size_t i = 0; i < m_blockCount; ++i) {
-        void* block = new_pool.memory.get() + i * m_blockSize;
-        *reinterpret_cast<void**>(block) = new_pool.free_list_head;
-        new_pool.free_list_head = block;
-        new_pool.free_count++;
+    try {
+        pools.push_back(std::move(new_pool));
+    } catch (const std::bad_alloc&) {
+        return std::unexpected(alloc_error::out_of_memory);
     }
-
-    pools.push_back(std::move(new_pool));
+    m_ownsMemory = true;
+    return {};
 }
 
 void allocator::pool_allocator::setAllocatorName(std::string_view name) {
@@ -0,0 +1,321 @@
+#include "allocator/slab_allocator.hpp"
+#include <algorithm>
+#include <bit>
+#include <new>
+#include <stdexcept>
+
+#if ALLOCATOR_DEBUG
+#define handle_allocation_error(msg) throwAllocationError(m_allocator, msg)
+#else
+#define handle_allocation_error(msg) return nullptr
+#endif
+
+allocator::slab_allocator::slab_allocator(size_t objectSize, size_t alignment,
+                                          object_callback constructor,
+                                          object_callback destructor, size_t maxEmptySlabs,
+                                          memory_provider* provider)
+    : m_maxEmptySlabs(maxEmptySlabs),
+      m_provider(provider ? provider : default_memory_provider()),
+      m_constructor(std::move(constructor)),
+      m_destructor(std::move(destructor)) {
+
+    if (objectSize == 0) {
+        throw std::invalid_argument(m_allocator + ": Object size must be greater than zero.");
+    }
+
+    if (alignment == 0) {
+        m_alignment = sizeof(void*); // 8 bytes
+    } else {
+        if (!isAlignmentPowerOfTwo(alignment)) {
+            throw std::invalid_argument(m_allocator + ": Alignment must be a power of two.");
+        }
+        if (alignment > MIN_SLAB_SIZE) {
+            throw std::invalid_argument(m_allocator + ": Alignment must be at most " +
+                                        std::to_string(MIN_SLAB_SIZE) + " bytes.");
+        }
+        m_alignment = std::max(alignment, sizeof(void*)); // the link word must be aligned
+    }
+
+    m_objectSize = getAlignedSize(objectSize, m_alignment);
+    m_slotSize = getAlignedSize(m_objectSize + sizeof(void*), m_alignment);
+
+    // at least a page and room for 8 objects, so the link and list overhead stays small
+    m_slabSize = std::max(MIN_SLAB_SIZE, std::bit_ceil(m_slotSize * 8));
+    m_objectsPerSlab = m_slabSize / m_slotSize;
+
+    if (m_slabSize > MAX_CAPACITY) {
+        throw std::invalid_argument(m_allocator +
+                                    ": Requested object size exceeds maximum capacity(64 MB).");
+    }
+}
+
+allocator::slab_allocator::~slab_allocator() {
+    releaseMemory();
+}
+
+void* allocator::slab_allocator::allocate(size_t size, size_t alignment) {
+    // not through try_allocate, an exception from the constructor reaches the caller
+    auto result = take_object(size, alignment);
+    if (!result) {
+        handle_allocation_error(describeAllocationError(result.error(), size));
+    }
+    return *result;
+}
+
+void* allocator::slab_allocator::allocate() {
+    return allocate(m_objectSize);
+}
+
+std::expected<void*, allocator::alloc_error>
+allocator::slab_allocator::try_allocate(size_t size, size_t alignment) noexcept {
+    try {
+        return take_object(size, alignment);
+    } catch (...) { // the constructor of a new slab threw, nothing was allocated
+        return std::unexpected(alloc_error::out_of_memory);
+    }
+}
+
+std::expected<void*, allocator::alloc_error> allocator::slab_allocator::try_allocate() noexcept {
+    return try_allocate(m_objectSize);
+}
+
+std::expected<void*, allocator::alloc_error>
+allocator::slab_allocator::take_object(size_t size, size_t alignment) {
+    if (size > m_objectSize) {
+        return std::unexpected(alloc_error::size_too_large);
+    }
+    if (alignment > m_alignment) {
+        return std::unexpected(alloc_error::invalid_alignment);
+    }
+
+    // partial slabs first so live objects stay packed, then cached empty slabs
+    slab* s = m_partial.head ? m_partial.head : m_empty.head;
+    if (!s) {
+        if ((m_slabs.size() + 1) * m_slabSize > MAX_CAPACITY) {
+            return std::unexpected(alloc_error::capacity_exceeded);
+        }
+        s = create_slab();
+        if (!s) {
+            return std::unexpected(alloc_error::out_of_memory);
+        }
+    }
+
+    void* object = s->free_list_head;
+    s->free_list_head = *link_of(object);
+    *link_of(object) = s; // allocated: the link names the owning slab
+    ++s->allocated_count;
+    ++m_allocatedCount;
+
+    move_to(s, s->allocated_count == m_objectsPerSlab ? slab_state::full : slab_state::partial);
+    return object;
+}
+
+void allocator::slab_allocator::deallocate(void* ptr) {
+    if (!ptr) {
+        throw std::invalid_argument(m_allocator + ": Attempted to deallocate a null pointer");
+    }
+
+    // slabs are aligned to their size, so the slab of an object is found by masking
+    auto p = reinterpret_cast<std::uintptr_t>(ptr);
+    auto it = m_slabs.find(p & ~(m_slabSize - 1));
+    if (it == m_slabs.end()) {
+        throw std::invalid_argument(m_allocator +
+                                    ": Pointer does not belong to any slab of this allocator");
+    }
+
+    slab* s = &it->second;
+    size_t offset = p - reinterpret_cast<std::uintptr_t>(s->memory);
+    if (offset % m_slotSize != 0 || offset / m_slotSize >= m_objectsPerSlab) {
+        throw std::invalid_argument(m_allocator +
+                                    ": Pointer is inside a slab but not at the start of an object");
+    }
+
+    if (*link_of(ptr) != s) {
+        throw std::invalid_argument(m_allocator + ": double free detected");
+    }
+
+    // back on the slab's free list, the object itself is left untouched
+    *link_of(ptr) = s->free_list_head;
+    s->free_list_head = ptr;
+    --s->allocated_count;
+    --m_allocatedCount;
+
+    if (s->allocated_count > 0) {
+        move_to(s, slab_state::partial);
+        return;
+    }
+
+    move_to(s, slab_state::empty);
+    if (m_empty.count > m_maxEmptySlabs) {
+        destroy_slab(s);
+    }
+}
+
+size_t allocator::slab_allocator::getAllocatedSize() const {
+    return m_allocatedCount * m_objectSize;
+}
+
+size_t allocator::slab_allocator::getObjectSize() const {
+    return m_objectSize;
+}
+
+void allocator::slab_allocator::reset() {
+    // objects are handed back in their constructed state, only the free lists are rebuilt
+    for (auto& [address, s] : m_slabs) {
+        s.free_list_head = nullptr;
+        for (size_t i = m_objectsPerSlab; i-- > 0;) {
+            void* object = s.memory + i * m_slotSize;
+            *link_of(object) = s.free_list_head;
+            s.free_list_head = object;
+        }
+        s.allocated_count = 0;
+        move_to(&s, slab_state::empty);
+    }
+    m_allocatedCount = 0;
+}
+
+void allocator::slab_allocator::releaseMemory() {
+    while (!m_slabs.empty()) {
+        destroy_slab(&m_slabs.begin()->second);
+    }
+    m_allocatedCount = 0;
+}
+
+void allocator::slab_allocator::setAllocatorName(std::string_view name) {
+    m_allocator = name;
+}
+
+size_t allocator::slab_allocator::reap() {
+    size_t reclaimed = 0;
+    while (m_empty.head) {
+        destroy_slab(m_empty.head);
+        ++reclaimed;
+    }
+    return reclaimed;
+}
+
+size_t allocator::slab_allocator::getSlabCount() const {
+    return m_slabs.size();
+}
+
+size_t allocator::slab_allocator::getObjectsPerSlab() const {
+    return m_objectsPerSlab;
+}
+
+void** allocator::slab_allocator::link_of(void* object) const {
+    return reinterpret_cast<void**>(static_cast<std::byte*>(object) + m_objectSize);
+}
+
+allocator::slab_allocator::slab* allocator::slab_allocator::create_slab() {
+    auto* memory = static_cast<std::byte*>(m_provider->acquire(m_slabSize, m_slabSize));
+    if (!memory) {
+        return nullptr;
+    }
+
+    // construct every object once and thread the free list, first slot at the head. The slab is
+    // only recorded after that, a constructor that throws leaves nothing half built behind.
+    void* head = nullptr;
+    size_t first = m_objectsPerSlab; // slots from first on are constructed
+    try {
+        for (; first > 0; --first) {
+            void* object = memory + (first - 1) * m_slotSize;
+            if (m_constructor) {
+                m_constructor(object);
+            }
+            *link_of(object) = head;
+            head = object;
+        }
+    } catch (...) {
+        destroy_objects(memory, first);
+        m_provider->release(memory, m_slabSize, m_slabSize);
+        throw;
+    }
+
+    slab* s = nullptr;
+    try {
+        s = &m_slabs[reinterpret_cast<std::uintptr_t>(memory)];
+    } catch (const std::bad_alloc&) {
+        destroy_objects(memory, 0);
+        m_provider->release(memory, m_slabSize, m_slabSize);
+        return nullptr;
+    }
+    s->memory = memory;
+    s->free_list_head = head;
+
+    s->state = slab_state::empty;
+    s->prev = nullptr;
+    s->next = m_empty.head;
+    if (s->next) {
+        s->next->prev = s;
+    }
+    m_empty.head = s;
+    ++m_empty.count;
+    return s;
+}
+
+void allocator::slab_allocator::destroy_slab(slab* s) {
+    // unlink from its list
+    slab_list& list = list_of(s->state);
+    if (s->prev) {
+        s->prev->next = s->next;
+    } else {
+        list.head = s->next;
+    }
+    if (s->next) {
+        s->next->prev = s->prev;
+    }
+    --list.count;
+
+    m_allocatedCount -= s->allocated_count;
+    destroy_objects(s->memory, 0);
+
+    std::byte* memory = s->memory;
+    m_slabs.erase(reinterpret_cast<std::uintptr_t>(memory));
+    m_provider->release(memory, m_slabSize, m_slabSize);
+}
+
+void allocator::slab_allocator::destroy_objects(std::byte* memory, size_t first) {
+    if (m_destructor) {
+        for (size_t i = first; i < m_objectsPerSlab; ++i) {
+            m_destructor(memory + i * m_slotSize);
+        }
+    }
+}
+
+void allocator::slab_allocator::move_to(slab* s, slab_state state) {
+    if (s->state == state) {
+        return;
+    }
+
+    slab_list& from = list_of(s->state);
+    if (s->prev) {
+        s->prev->next = s->next;
+    } else {
+        from.head = s->next;
+    }
+    if (s->next) {
+        s->next->prev = s->prev;
+    }
+    --from.count;
+
+    slab_list& to = list_of(state);
+    s->state = state;
+    s->prev = nullptr;
+    s->next = to.head;
+    if (to.head) {
+        to.head->prev = s;
+    }
+    to.head = s;
+    ++to.count;
+}
+
+allocator::slab_allocator::slab_list& allocator::slab_allocator::list_of(slab_state state) {
+    switch (state) {
+    case slab_state::full:
+        return m_full;
+    case slab_state::partial:
+        return m_partial;
+    default:
+        return m_empty;
+    }
+}
@@ -1,4 +1,6 @@
 #include "allocator/stack_allocator.hpp"
+#include <new>
+#include <cstdint>
 #include <stdexcept>
 
 #if ALLOCATOR_DEBUG
@@ -7,8 +9,10 @@
 #define handle_allocation_error(msg) return nullptr
 #endif
 
-allocator::stack_allocator::stack_allocator(size_t bufferSize, size_t alignment, bool resizable)
-    : m_bufferSize(bufferSize), m_resizable(resizable) {
+allocator::stack_allocator::stack_allocator(size_t bufferSize, size_t alignment, bool resizable,
+                                            memory_provider* provider)
+    : m_bufferSize(bufferSize), m_resizable(resizable),
+      m_provider(provider ? provider : default_memory_provider()) {
 
     if (bufferSize > MAX_CAPACITY) {
         throw std::invalid_argument(m_allocator + ": Requested size exceeds maximum capacity(" +
@@ -37,93 +41,149 @@ allocator::stack_allocator::~stack_allocator() {
     releaseMemory();
 }
 
-void* allocator::stack_allocator::allocate(size_t size, size_t alignment) {
+// the moved-from side keeps the configuration and is left without buffers by the swap
+allocator::stack_allocator::stack_allocator(stack_allocator&& other) noexcept
+    : m_alignment(other.m_alignment), m_bufferSize(other.m_bufferSize), m_lastallocation(0),
+      m_resizable(other.m_resizable), m_provider(other.m_provider) {
+    swap(other);
+}
+
+allocator::stack_allocator&
+allocator::stack_allocator::operator=(stack_allocator&& other) noexcept {
+    if (this != &other) {
+        swap(other);
+        other.releaseMemory(); // our old buffers go with the moved-from side
+    }
+    return *this;
+}
+
+void allocator::stack_allocator::swap(stack_allocator& other) noexcept {
+    using std::swap;
+#if ALLOCATOR_DEBUG || ALLOCATOR_PARANOID
+    swap(allocation_history, other.allocation_history);
+#endif
+    swap(m_alignment, other.m_alignment);
+    swap(m_bufferSize, other.m_bufferSize);
+    swap(m_lastallocation, other.m_lastallocation);
+    swap(buffers, other.buffers);
+    swap(m_resizable, other.m_resizable);
+    swap(m_ownsMemory, other.m_ownsMemory);
+    swap(m_provider, other.m_provider);
+    swap(m_allocator, other.m_allocator);
+}
+
+void* allocator::stack_allocator::allocate_slow(size_t size, size_t alignment) {
+    auto result = try_allocate_slow(size, alignment);
+    if (!result) {
+        if (result.error() == alloc_error::invalid_alignment) {
+            throw std::invalid_argument(m_allocator + ": Alignment must be a power of two of at " +
+                                        "least " + std::to_string(alignof(int)) + " bytes.");
+        }
+        handle_allocation_error(describeAllocationError(result.error(), size));
+    }
+    return *result;
+}
+
+std::expected<void*, allocator::alloc_error>
+allocator::stack_allocator::try_allocate_slow(size_t size, size_t alignment) noexcept {
     if (!m_ownsMemory) {
-        handle_allocation_error("Allocator has released its memory");
+        return std::unexpected(alloc_error::no_memory);
     }
 
     if (alignment == 0) {
         alignment = m_alignment;
-    } else {
-        if (!isAlignmentPowerOfTwo(alignment)) {
-            throw std::invalid_argument(m_allocator + ": Alignment must be a power of two.");
-        }
-        if (alignment < alignof(int)) {
-            throw std::invalid_argument(m_allocator + ": Alignment must be greater than " +
-                                        std::to_string(alignof(int)) + " bytes.");
-        }
+    } else if (!isAlignmentPowerOfTwo(alignment) || alignment < alignof(int)) {
+        return std::unexpected(alloc_error::invalid_alignment);
     }
 
     auto alignSize = getAlignedSize(size, alignment);
 
-    if (alignSize > m_bufferSize) {
-        handle_allocation_error("Requested size exceeds buffer size(" +
-                                std::to_string(m_bufferSize) + " bytes");
+    if (size > alignSize || alignSize > m_bufferSize) {
+        return std::unexpected(alloc_error::size_too_large);
     }
 
-    auto& lastbuffer = buffers.back();
-
-    if (lastbuffer.offset + alignSize <= lastbuffer.size) {
-        void* ptr = lastbuffer.memory.get() + lastbuffer.offset;
-        lastbuffer.offset += alignSize;
-        m_lastallocation = alignSize;
-
-#if ALLOCATOR_DEBUG
-        allocation_history.push_back({ptr, alignSize});
-#endif
-
+    if (void* ptr = bump(alignSize)) {
         return ptr;
     }
 
     // Current buffer full, need new one
-    allocate_new_buffer();
-    return allocate(size, alignment);
+    if (auto added = add_buffer(); !added) {
+        return std::unexpected(added.error());
+    }
+    // bump can still fail in checked builds, when the allocation history cannot grow
+    if (void* ptr = bump(alignSize)) {
+        return ptr;
+    }
+    return std::unexpected(alloc_error::out_of_memory);
 }
 
-void allocator::stack_allocator::deallocate(void* ptr) {
+template <allocator::check_policy Policy>
+void allocator::stack_allocator::deallocate_slow(void* ptr) {
+    constexpr bool checked = Policy != check_policy::unchecked;
 
-    if (!ptr) {
+    if (checked && !ptr) {
         throw std::invalid_argument(m_allocator + ": Attempted to deallocate a null pointer");
     }
 
-    if (!m_ownsMemory) {
+    if (checked && !m_ownsMemory) {
         throw std::invalid_argument(m_allocator + ": Allocator does not hold any memory on heap");
     }
 
     auto& lastbuffer = buffers.back();
-
-#if ALLOCATOR_DEBUG
-    auto& last_alloc = allocation_history.back();
-    if (last_alloc.ptr != ptr) {
-        throw std::invalid_argument(m_allocator + ": Invalid LIFO deallocation order");
-    }
-    allocation_history.pop_back();
-#endif
-
-    // release or debug check are off:
-    // Assume ptr is the last allocation (LIFO)
     auto raw_ptr = static_cast<std::byte*>(ptr);
     auto top_ptr = lastbuffer.memory.get() + lastbuffer.offset;
 
-    if (raw_ptr >= top_ptr) {
+    if constexpr (Policy == check_policy::paranoid) {
+#if ALLOCATOR_DEBUG || ALLOCATOR_PARANOID
+        if (allocation_history.empty() || allocation_history.back().ptr != ptr) {
+            throw std::invalid_argument(m_allocator + ": Invalid LIFO deallocation order");
+        }
+#else
+        // without the history only the most recent allocation is known
+        if (m_lastallocation != 0 && raw_ptr != top_ptr - m_lastallocation) {
+            throw std::invalid_argument(m_allocator + ": Invalid LIFO deallocation order");
+        }
+#endif
+    }
+
+    // checked: ptr must lie below the top of the top buffer, frees to an earlier point are
+    // accepted and release everything above it
+    if (checked && raw_ptr >= top_ptr) {
         throw std::invalid_argument(m_allocator +
                                     ": Pointer is beyond current top; memory corruption suspected");
     }
 
-    size_t size = top_ptr - raw_ptr;
-    if (size > lastbuffer.offset) {
+    if (checked && static_cast<size_t>(top_ptr - raw_ptr) > lastbuffer.offset) {
         throw std::runtime_error(m_allocator + ": Calculated deallocation size exceeds current "
                                                "allocated offset; memory corruption suspected");
     }
 
-    lastbuffer.offset -= size;
-    m_lastallocation = 0;
+    drop_to(raw_ptr);
+}
 
-    // Drop empty buffer unless it's the only one
-    if (lastbuffer.offset == 0 && buffers.size() > 1) {
-        buffers.pop_back();
+// the inline deallocate instantiates the slow path of each policy
+template void allocator::stack_allocator::deallocate_slow<allocator::check_policy::checked>(void*);
+template void allocator::stack_allocator::deallocate_slow<allocator::check_policy::paranoid>(void*);
+
+#if ALLOCATOR_DEBUG || ALLOCATOR_PARANOID
+void allocator::stack_allocator::trim_history() noexcept {
+    // the history is in allocation order, so the first entry still below a top ends the trim
+    auto isLive = [this](void* ptr) {
+        auto p = reinterpret_cast<std::uintptr_t>(ptr);
+        for (const auto& buffer : buffers) {
+            auto start = reinterpret_cast<std::uintptr_t>(buffer.memory.get());
+            if (p >= start && p < start + buffer.offset) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    while (!allocation_history.empty() && !isLive(allocation_history.back().ptr)) {
+        allocation_history.pop_back();
     }
 }
+#endif
 
 size_t allocator::stack_allocator::getAllocatedSize() const {
     size_t totalAllocated = 0;
@@ -137,7 +197,7 @@ size_t allocator::stack_allocator::getAllocatedSize() const {
 size_t allocator::stack_allocator::getObjectSize() const {
     size_t lastObjectSize = 0;
 
-#if ALLOCATOR_DEBUG
+#if ALLOCATOR_DEBUG || ALLOCATOR_PARANOID
     if (!allocation_history.empty()) {
         lastObjectSize = allocation_history.back().size;
     }
@@ -157,7 +217,7 @@ void allocator::stack_allocator::reset() {
             buffers.pop_back();
         }
 
-#if ALLOCATOR_DEBUG
+#if ALLOCATOR_DEBUG || ALLOCATOR_PARANOID
         // Clear allocation history
         allocation_history.clear();
 #endif
@@ -172,7 +232,7 @@ void allocator::stack_allocator::reset() {
 void allocator::stack_allocator::releaseMemory() {
     buffers.clear();
 
-#if ALLOCATOR_DEBUG
+#if ALLOCATOR_DEBUG || ALLOCATOR_PARANOID
     // Clear allocation history
     allocation_history.clear();
 #endif
@@ -181,21 +241,32 @@ void allocator::stack_allocator::releaseMemory() {
 }
 
 void allocator::stack_allocator::allocate_new_buffer() {
+    if (auto added = add_buffer(); !added) {
+        throwAllocationError(m_allocator, describeAllocationError(added.error(), m_bufferSize));
+    }
+}
+
+std::expected<void, allocator::alloc_error> allocator::stack_allocator::add_buffer() noexcept {
     if (m_ownsMemory) {
-        if (!m_resizable) {
-            throwAllocationError(m_allocator, "Cannot allocate new buffer in non-resizable mode");
-        } else if (m_resizable && (m_bufferSize * (buffers.size() + 1) > MAX_CAPACITY)) {
-            throwAllocationError(m_allocator, "Exceeds maximum capacity(" +
-                                                  std::to_string(MAX_CAPACITY / (1024 * 1024)) +
-                                                  " MB)");
+        // non-resizable stacks keep their single buffer, resizable ones stop at 64 MB
+        if (!m_resizable || m_bufferSize * (buffers.size() + 1) > MAX_CAPACITY) {
+            return std::unexpected(alloc_error::capacity_exceeded);
         }
     }
 
     buffer new_buffer;
-    new_buffer.memory = std::make_unique<std::byte[]>(m_bufferSize);
-    m_ownsMemory = true;
+    new_buffer.memory = acquire_buffer(*m_provider, m_bufferSize, alignof(std::max_align_t));
+    if (!new_buffer.memory) {
+        return std::unexpected(alloc_error::out_of_memory);
+    }
     new_buffer.size = m_bufferSize;
-    buffers.push_back(std::move(new_buffer));
+    try {
+        buffers.push_back(std::move(new_buffer));
+    } catch (const std::bad_alloc&) {
+        return std::unexpected(alloc_error::out_of_memory);
+    }
+    m_ownsMemory = true;
+    return {};
 }
 
 void allocator::stack_allocator::setAllocatorName(std::string_view name) {
@@ -238,4 +309,9 @@ void allocator::stack_allocator::reset_to_mark(const std::pair<size_t, size_t>&
     }
 
     buffers.back().offset = offset;
+    m_lastallocation = 0;
+
+#if ALLOCATOR_DEBUG || ALLOCATOR_PARANOID
+    trim_history();
+#endif
 }
\ No newline at end of file
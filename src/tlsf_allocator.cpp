@@ -0,0 +1,368 @@
+#include "allocator/tlsf_allocator.hpp"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+#if ALLOCATOR_DEBUG
+#define handle_allocation_error(msg) throwAllocationError(m_allocator, msg)
+#else
+#define handle_allocation_error(msg) return nullptr
+#endif
+
+allocator::tlsf_allocator::tlsf_allocator(size_t bufferSize, memory_provider* provider)
+    : m_provider(provider ? provider : default_memory_provider()) {
+    if (bufferSize < MIN_CAPACITY || bufferSize > MAX_CAPACITY) {
+        throw std::invalid_argument(m_allocator + ": Buffer size must be between " +
+                                    std::to_string(MIN_CAPACITY / 1024) + "KB and " +
+                                    std::to_string(MAX_CAPACITY / (1024 * 1024)) + "MB");
+    }
+
+    m_bufferSize = getAlignedSize(bufferSize, ALIGN_SIZE);
+    allocate_new_buffer();
+}
+
+allocator::tlsf_allocator::~tlsf_allocator() {
+    releaseMemory();
+}
+
+void* allocator::tlsf_allocator::allocate(size_t size, size_t alignment) {
+    auto result = try_allocate(size, alignment);
+    if (!result) {
+        handle_allocation_error(describeAllocationError(result.error(), size));
+    }
+    return *result;
+}
+
+std::expected<void*, allocator::alloc_error>
+allocator::tlsf_allocator::try_allocate(size_t size, size_t alignment) noexcept {
+    if (!m_ownsMemory) {
+        return std::unexpected(alloc_error::no_memory);
+    }
+
+    if (alignment != 0 && !isAlignmentPowerOfTwo(alignment)) {
+        return std::unexpected(alloc_error::invalid_alignment);
+    }
+
+    if (size >= BLOCK_SIZE_MAX) {
+        return std::unexpected(alloc_error::size_too_large);
+    }
+
+    size_t adjusted = std::max(getAlignedSize(size, ALIGN_SIZE), BLOCK_SIZE_MIN);
+    alignment = std::max(alignment, ALIGN_SIZE);
+
+    // Over-aligned requests look for room for the payload plus a leading gap, which must be
+    // able to hold a free block of its own so it can be given back
+    constexpr size_t gapMinimum = sizeof(block_header);
+    size_t searchSize = adjusted;
+    if (alignment > ALIGN_SIZE) {
+        searchSize = getAlignedSize(adjusted + alignment + gapMinimum, alignment);
+    }
+
+    block_header* block = locate_free_block(searchSize);
+    if (!block) {
+        return std::unexpected(alloc_error::out_of_memory);
+    }
+
+    if (alignment > ALIGN_SIZE) {
+        auto ptr = reinterpret_cast<uintptr_t>(to_ptr(block));
+        uintptr_t aligned = getAlignedSize(ptr, alignment);
+        size_t gap = aligned - ptr;
+
+        // a gap too small for a block header is pushed to the next aligned address
+        if (gap != 0 && gap < gapMinimum) {
+            size_t offset = std::max(gapMinimum - gap, alignment);
+            aligned = getAlignedSize(aligned + offset, alignment);
+            gap = aligned - ptr;
+        }
+        if (gap != 0) {
+            block = trim_free_leading(block, gap);
+        }
+    }
+
+    trim_free(block, adjusted);
+    mark_used(block);
+
+    m_lastAllocation = get_block_size(block);
+    m_allocatedSize += m_lastAllocation;
+    return to_ptr(block);
+}
+
+void allocator::tlsf_allocator::deallocate(void* ptr) {
+    if (!ptr) {
+        throw std::invalid_argument(m_allocator + ": Attempted to deallocate a null pointer");
+    }
+
+    if (!m_ownsMemory) {
+        throw std::invalid_argument(m_allocator + ": Allocator does not hold any memory on heap");
+    }
+
+    // constant-time checks only: inside the buffer, on the payload grid and not already free
+    auto start = reinterpret_cast<uintptr_t>(m_memory.get());
+    auto p = reinterpret_cast<uintptr_t>(ptr);
+    if (p < start + BLOCK_START_OFFSET || p >= start + m_bufferSize || p % ALIGN_SIZE != 0) {
+        throw std::invalid_argument(m_allocator + ": Pointer not allocated by this allocator");
+    }
+
+    block_header* block = from_ptr(ptr);
+    if (block->size & BLOCK_FREE) {
+        throw std::invalid_argument(m_allocator + ": double free detected");
+    }
+
+    m_allocatedSize -= get_block_size(block);
+
+    mark_free(block);
+    block = merge_prev(block);
+    block = merge_next(block);
+    insert_free_block(block);
+}
+
+size_t allocator::tlsf_allocator::getAllocatedSize() const {
+    return m_allocatedSize;
+}
+
+size_t allocator::tlsf_allocator::getObjectSize() const {
+    return m_lastAllocation;
+}
+
+void allocator::tlsf_allocator::reset() {
+    if (m_ownsMemory) {
+        init_pool();
+    } else {
+        allocate_new_buffer();
+    }
+}
+
+void allocator::tlsf_allocator::releaseMemory() {
+    m_memory.reset();
+    m_ownsMemory = false;
+    m_flBitmap = 0;
+    m_slBitmap.fill(0);
+    for (auto& lists : m_blocks) {
+        lists.fill(nullptr);
+    }
+    m_allocatedSize = 0;
+    m_lastAllocation = 0;
+}
+
+void allocator::tlsf_allocator::setAllocatorName(std::string_view name) {
+    m_allocator = name;
+}
+
+void allocator::tlsf_allocator::allocate_new_buffer() {
+    m_memory = acquire_buffer(*m_provider, m_bufferSize, alignof(std::max_align_t));
+    if (!m_memory) {
+        throw std::bad_alloc();
+    }
+    m_ownsMemory = true;
+    init_pool();
+}
+
+void allocator::tlsf_allocator::init_pool() {
+    m_flBitmap = 0;
+    m_slBitmap.fill(0);
+    for (auto& lists : m_blocks) {
+        lists.fill(nullptr);
+    }
+    m_allocatedSize = 0;
+    m_lastAllocation = 0;
+
+    // One free block spanning the buffer, followed by a zero-size used sentinel so merging
+    // never looks past the end. The first prev_phys word and the sentinel's size are overhead.
+    // The buffer is uninitialized, the sentinel is written before mark_free() updates it.
+    auto* block = reinterpret_cast<block_header*>(m_memory.get());
+    block->size = m_bufferSize - BLOCK_START_OFFSET - BLOCK_OVERHEAD;
+    block_header* sentinel = next_block(block);
+    sentinel->size = 0; // size 0, used
+
+    mark_free(block); // also sets PREV_FREE on the sentinel
+    insert_free_block(block);
+}
+
+size_t allocator::tlsf_allocator::get_block_size(const block_header* block) {
+    return block->size & ~(BLOCK_FREE | PREV_FREE);
+}
+
+void allocator::tlsf_allocator::set_block_size(block_header* block, size_t size) {
+    block->size = size | (block->size & (BLOCK_FREE | PREV_FREE));
+}
+
+std::byte* allocator::tlsf_allocator::to_ptr(block_header* block) {
+    return reinterpret_cast<std::byte*>(block) + BLOCK_START_OFFSET;
+}
+
+allocator::tlsf_allocator::block_header* allocator::tlsf_allocator::from_ptr(void* ptr) {
+    return reinterpret_cast<block_header*>(static_cast<std::byte*>(ptr) - BLOCK_START_OFFSET);
+}
+
+allocator::tlsf_allocator::block_header*
+allocator::tlsf_allocator::next_block(block_header* block) {
+    // the next header starts with its prev_phys word, inside the last word of this payload
+    return reinterpret_cast<block_header*>(to_ptr(block) + get_block_size(block) -
+                                           BLOCK_OVERHEAD);
+}
+
+allocator::tlsf_allocator::block_header*
+allocator::tlsf_allocator::link_next(block_header* block) {
+    block_header* next = next_block(block);
+    next->prev_phys = block;
+    return next;
+}
+
+void allocator::tlsf_allocator::mark_free(block_header* block) {
+    block_header* next = link_next(block);
+    next->size |= PREV_FREE;
+    block->size |= BLOCK_FREE;
+}
+
+void allocator::tlsf_allocator::mark_used(block_header* block) {
+    next_block(block)->size &= ~PREV_FREE;
+    block->size &= ~BLOCK_FREE;
+}
+
+bool allocator::tlsf_allocator::can_split(const block_header* block, size_t size) {
+    return get_block_size(block) >= sizeof(block_header) + size;
+}
+
+allocator::tlsf_allocator::block_header* allocator::tlsf_allocator::split(block_header* block,
+                                                                          size_t size) {
+    auto* remaining = reinterpret_cast<block_header*>(to_ptr(block) + size - BLOCK_OVERHEAD);
+    size_t remainingSize = get_block_size(block) - (size + BLOCK_OVERHEAD);
+
+    remaining->size = remainingSize;
+    set_block_size(block, size);
+    mark_free(remaining);
+    return remaining;
+}
+
+allocator::tlsf_allocator::block_header* allocator::tlsf_allocator::absorb(block_header* prev,
+                                                                           block_header* block) {
+    prev->size += get_block_size(block) + BLOCK_OVERHEAD;
+    link_next(prev);
+    return prev;
+}
+
+void allocator::tlsf_allocator::mapping_insert(size_t size, int& fl, int& sl) {
+    if (size < SMALL_BLOCK_SIZE) {
+        // small blocks share the first list row, split linearly
+        fl = 0;
+        sl = static_cast<int>(size / (SMALL_BLOCK_SIZE / SL_INDEX_COUNT));
+    } else {
+        int bit = std::bit_width(size) - 1;
+        sl = static_cast<int>((size >> (bit - SL_INDEX_COUNT_LOG2)) ^ (1u << SL_INDEX_COUNT_LOG2));
+        fl = bit - (FL_INDEX_SHIFT - 1);
+    }
+}
+
+void allocator::tlsf_allocator::mapping_search(size_t size, int& fl, int& sl) {
+    // round up so that any block of the list found is large enough (good fit, not best fit)
+    if (size >= SMALL_BLOCK_SIZE) {
+        size += (size_t{1} << (std::bit_width(size) - 1 - SL_INDEX_COUNT_LOG2)) - 1;
+    }
+    mapping_insert(size, fl, sl);
+}
+
+void allocator::tlsf_allocator::insert_free_block(block_header* block) {
+    int fl = 0;
+    int sl = 0;
+    mapping_insert(get_block_size(block), fl, sl);
+
+    block_header* head = m_blocks[fl][sl];
+    block->next_free = head;
+    block->prev_free = nullptr;
+    if (head) {
+        head->prev_free = block;
+    }
+    m_blocks[fl][sl] = block;
+
+    m_flBitmap |= 1u << fl;
+    m_slBitmap[fl] |= 1u << sl;
+}
+
+void allocator::tlsf_allocator::remove_free_block(block_header* block) {
+    int fl = 0;
+    int sl = 0;
+    mapping_insert(get_block_size(block), fl, sl);
+
+    if (block->prev_free) {
+        block->prev_free->next_free = block->next_free;
+    } else {
+        m_blocks[fl][sl] = block->next_free;
+        if (!m_blocks[fl][sl]) {
+            m_slBitmap[fl] &= ~(1u << sl);
+            if (!m_slBitmap[fl]) {
+                m_flBitmap &= ~(1u << fl);
+            }
+        }
+    }
+    if (block->next_free) {
+        block->next_free->prev_free = block->prev_free;
+    }
+}
+
+allocator::tlsf_allocator::block_header* allocator::tlsf_allocator::locate_free_block(size_t size) {
+    int fl = 0;
+    int sl = 0;
+    mapping_search(size, fl, sl);
+    if (fl >= FL_INDEX_COUNT) {
+        return nullptr;
+    }
+
+    // first non-empty list at (fl, >= sl), otherwise the first one at a higher first level
+    std::uint32_t slMap = m_slBitmap[fl] & (~0u << sl);
+    if (!slMap) {
+        std::uint32_t flMap = m_flBitmap & (~0u << (fl + 1));
+        if (!flMap) {
+            return nullptr;
+        }
+        fl = std::countr_zero(flMap);
+        slMap = m_slBitmap[fl];
+    }
+    sl = std::countr_zero(slMap);
+
+    block_header* block = m_blocks[fl][sl];
+    remove_free_block(block);
+    return block;
+}
+
+void allocator::tlsf_allocator::trim_free(block_header* block, size_t size) {
+    // give the unused tail back as a free block when it is large enough to hold one
+    if (can_split(block, size)) {
+        block_header* remaining = split(block, size);
+        link_next(block);
+        remaining->size |= PREV_FREE;
+        insert_free_block(remaining);
+    }
+}
+
+allocator::tlsf_allocator::block_header*
+allocator::tlsf_allocator::trim_free_leading(block_header* block, size_t gap) {
+    // the gap in front of an aligned payload becomes a free block, the rest is returned
+    block_header* remaining = block;
+    if (can_split(block, gap)) {
+        remaining = split(block, gap - BLOCK_OVERHEAD);
+        remaining->size |= PREV_FREE;
+        link_next(block);
+        insert_free_block(block);
+    }
+    return remaining;
+}
+
+allocator::tlsf_allocator::block_header*
+allocator::tlsf_allocator::merge_prev(block_header* block) {
+    if (block->size & PREV_FREE) {
+        block_header* prev = block->prev_phys;
+        remove_free_block(prev);
+        block = absorb(prev, block);
+    }
+    return block;
+}
+
+allocator::tlsf_allocator::block_header*
+allocator::tlsf_allocator::merge_next(block_header* block) {
+    block_header* next = next_block(block);
+    if (next->size & BLOCK_FREE) {
+        remove_free_block(next);
+        block = absorb(block, next);
+    }
+    return block;
+}
@@ -0,0 +1,238 @@
+#include "allocator/tree_buddy_allocator.hpp"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+#if ALLOCATOR_DEBUG
+#define handle_allocation_error(msg) throwAllocationError(m_allocator, msg)
+#else
+#define handle_allocation_error(msg) return nullptr
+#endif
+
+allocator::tree_buddy_allocator::tree_buddy_allocator(size_t capacity, size_t minBlock,
+                                                      bool backed, memory_provider* provider)
+    : m_minBlock(minBlock), m_backed(backed),
+      m_provider(provider ? provider : default_memory_provider()) {
+
+    if (!isAlignmentPowerOfTwo(minBlock)) {
+        throw std::invalid_argument(m_allocator + ": Minimum block size must be a power of two.");
+    }
+
+    if (capacity < minBlock) {
+        throw std::invalid_argument(m_allocator +
+                                    ": Capacity must be at least the minimum block size.");
+    }
+
+    if (backed && capacity > MAX_CAPACITY) {
+        throw std::invalid_argument(m_allocator + ": Requested size exceeds maximum capacity(" +
+                                    std::to_string(MAX_CAPACITY / (1024 * 1024)) + " MB).");
+    }
+
+    m_capacity = getAlignedSize(capacity, minBlock);
+    m_minShift = static_cast<unsigned>(std::countr_zero(minBlock));
+    m_leaves = std::bit_ceil(m_capacity >> m_minShift);
+    m_maxOrder = static_cast<unsigned>(std::countr_zero(m_leaves));
+
+    if (m_leaves > MAX_LEAVES) {
+        throw std::invalid_argument(m_allocator + ": Too many minimum blocks (max " +
+                                    std::to_string(MAX_LEAVES) + "), use a larger minBlock.");
+    }
+
+    allocate_new_buffer();
+}
+
+allocator::tree_buddy_allocator::~tree_buddy_allocator() {
+    releaseMemory();
+}
+
+void* allocator::tree_buddy_allocator::allocate(size_t size, size_t alignment) {
+    if (!m_backed) {
+        handle_allocation_error("No backing memory, use allocate_range()");
+    }
+
+    auto result = try_allocate(size, alignment);
+    if (!result) {
+        handle_allocation_error(describeAllocationError(result.error(), size));
+    }
+    return *result;
+}
+
+std::expected<void*, allocator::alloc_error>
+allocator::tree_buddy_allocator::try_allocate(size_t size,
+                                              [[maybe_unused]] size_t alignment) noexcept {
+
+    // blocks are aligned to their own size relative to the buffer start, an explicit alignment
+    // is ignored like in buddy_allocator
+
+    // without backing memory there is nothing to point to, allocate_range() hands out offsets
+    if (!m_ownsMemory || !m_backed) {
+        return std::unexpected(alloc_error::no_memory);
+    }
+
+    if (size > m_capacity) {
+        return std::unexpected(alloc_error::size_too_large);
+    }
+
+    size_t offset = allocate_range(size);
+    if (offset == npos) {
+        return std::unexpected(alloc_error::out_of_memory);
+    }
+
+    return m_memory.get() + offset;
+}
+
+void allocator::tree_buddy_allocator::deallocate(void* ptr) {
+    if (!ptr) {
+        throw std::invalid_argument(m_allocator + ": Attempted to deallocate a null pointer");
+    }
+
+    if (!m_ownsMemory || !m_backed) {
+        throw std::invalid_argument(m_allocator + ": Allocator does not hold any memory on heap");
+    }
+
+    auto start = reinterpret_cast<std::uintptr_t>(m_memory.get());
+    auto p = reinterpret_cast<std::uintptr_t>(ptr);
+    if (p < start || p >= start + m_capacity) {
+        throw std::invalid_argument(m_allocator + ": Pointer not allocated by this allocator");
+    }
+
+    deallocate_range(p - start);
+}
+
+size_t allocator::tree_buddy_allocator::allocate_range(size_t size) {
+    if (!m_ownsMemory) {
+        return npos;
+    }
+
+    size_t units = std::max<size_t>(1, (size + m_minBlock - 1) >> m_minShift);
+    auto order = static_cast<unsigned>(std::bit_width(units - 1)); // ceil(log2(units))
+
+    if (order > m_maxOrder || (m_tree[0] & LONGEST_MASK) < order + 1) {
+        return npos;
+    }
+
+    // descend towards a node of the wanted order, taking the left child whenever it fits
+    size_t index = 0;
+    for (unsigned nodeOrder = m_maxOrder; nodeOrder != order; --nodeOrder) {
+        size_t left = 2 * index + 1;
+        index = ((m_tree[left] & LONGEST_MASK) >= order + 1) ? left : left + 1;
+    }
+
+    m_tree[index] = ALLOCATED;
+    update_parents(index, order);
+
+    // position of the node within its depth gives the offset
+    size_t firstAtDepth = (size_t{1} << (m_maxOrder - order)) - 1;
+    size_t offset = ((index - firstAtDepth) << order) << m_minShift;
+
+    m_lastAllocation = m_minBlock << order;
+    m_allocatedSize += m_lastAllocation;
+    return offset;
+}
+
+void allocator::tree_buddy_allocator::deallocate_range(size_t offset) {
+    if (!m_ownsMemory) {
+        throw std::invalid_argument(m_allocator + ": Allocator has released its memory");
+    }
+
+    if (offset >= m_capacity || offset % m_minBlock != 0) {
+        throw std::invalid_argument(m_allocator + ": Offset not allocated by this allocator");
+    }
+
+    // climb from the leaf until the node the allocation was carved at
+    size_t unit = offset >> m_minShift;
+    size_t index = unit + m_leaves - 1;
+    unsigned order = 0;
+    while (!(m_tree[index] & ALLOCATED)) {
+        if (index == 0) {
+            throw std::invalid_argument(m_allocator +
+                                        ": Offset not allocated or double free detected");
+        }
+        index = (index - 1) / 2;
+        ++order;
+    }
+
+    if (unit % (size_t{1} << order) != 0) {
+        throw std::invalid_argument(m_allocator +
+                                    ": Offset does not point to the start of an allocation");
+    }
+
+    m_tree[index] = static_cast<std::uint8_t>(order + 1);
+    update_parents(index, order);
+    m_allocatedSize -= m_minBlock << order;
+}
+
+size_t allocator::tree_buddy_allocator::getAllocatedSize() const {
+    return m_allocatedSize;
+}
+
+size_t allocator::tree_buddy_allocator::getObjectSize() const {
+    return m_lastAllocation; // granted size of the last allocation
+}
+
+void allocator::tree_buddy_allocator::reset() {
+    if (m_ownsMemory) {
+        build_tree();
+        m_allocatedSize = 0;
+        m_lastAllocation = 0;
+    } else {
+        allocate_new_buffer();
+    }
+}
+
+void allocator::tree_buddy_allocator::releaseMemory() {
+    m_tree.reset();
+    m_memory.reset();
+    m_allocatedSize = 0;
+    m_lastAllocation = 0;
+    m_ownsMemory = false;
+}
+
+void allocator::tree_buddy_allocator::setAllocatorName(std::string_view name) {
+    m_allocator = name;
+}
+
+void allocator::tree_buddy_allocator::allocate_new_buffer() {
+    m_tree = std::make_unique<std::uint8_t[]>(2 * m_leaves - 1);
+    if (m_backed) {
+        m_memory = acquire_buffer(*m_provider, m_capacity, alignof(std::max_align_t));
+        if (!m_memory) {
+            throw std::bad_alloc();
+        }
+    }
+    m_ownsMemory = true;
+    build_tree();
+}
+
+void allocator::tree_buddy_allocator::build_tree() {
+    // leaves past the capacity (padding up to a power of two) start with nothing free,
+    // so the tree can manage any capacity without handing out the padding
+    size_t units = m_capacity >> m_minShift;
+    for (size_t leaf = 0; leaf < m_leaves; ++leaf) {
+        m_tree[m_leaves - 1 + leaf] = (leaf < units) ? 1 : 0;
+    }
+
+    for (size_t index = m_leaves - 1; index-- > 0;) {
+        auto depth = static_cast<unsigned>(std::bit_width(index + 1) - 1);
+        m_tree[index] = combine(index, m_maxOrder - depth);
+    }
+}
+
+void allocator::tree_buddy_allocator::update_parents(size_t index, unsigned order) {
+    while (index != 0) {
+        index = (index - 1) / 2;
+        ++order;
+        m_tree[index] = combine(index, order);
+    }
+}
+
+std::uint8_t allocator::tree_buddy_allocator::combine(size_t index, unsigned order) const {
+    unsigned left = m_tree[2 * index + 1] & LONGEST_MASK;
+    unsigned right = m_tree[2 * index + 2] & LONGEST_MASK;
+
+    // both halves entirely free: the node is one free run of its own order
+    if (left == order && right == order) {
+        return static_cast<std::uint8_t>(order + 1);
+    }
+    return static_cast<std::uint8_t>(std::max(left, right));
+}
@@ -0,0 +1,105 @@
+#include "allocator/buddy_allocator.hpp"
+#include "allocator/pool_allocator.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <list>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+template <typename T> using adapter = allocator::AllocatorAdapter<T>;
+
+// Node containers rebind the adapter to their node types
+TEST_CASE("AllocatorAdapter - Node based containers", "[allocator_adapter][containers]") {
+    allocator::buddy_allocator buddy(1024 * 1024);
+
+    {
+        std::list<int, adapter<int>> values{adapter<int>(&buddy)};
+        std::map<int, std::string, std::less<>, adapter<std::pair<const int, std::string>>> names{
+            adapter<std::pair<const int, std::string>>(&buddy)};
+        for (int i = 0; i < 100; ++i) {
+            values.push_back(i);
+            names.emplace(i, std::to_string(i));
+        }
+        values.remove_if([](int v) { return v % 2 == 0; });
+        names.erase(names.begin(), names.find(50));
+
+        REQUIRE(values.size() == 50);
+        REQUIRE(names.begin()->second == "50");
+        REQUIRE(buddy.getAllocatedSize() > 0);
+    }
+    REQUIRE(buddy.getAllocatedSize() == 0);
+}
+
+// Single nodes go to the pool, arrays to the general allocator
+TEST_CASE("AllocatorAdapter - Node routing", "[allocator_adapter][routing]") {
+    allocator::buddy_allocator buddy(1024 * 1024);
+    allocator::pool_allocator nodes(64, 1024);
+
+    {
+        using value = std::pair<const int, int>;
+        std::unordered_map<int, int, std::hash<int>, std::equal_to<>, adapter<value>> table{
+            0, std::hash<int>{}, std::equal_to<>{}, adapter<value>(&buddy, &nodes)};
+        for (int i = 0; i < 500; ++i) {
+            table[i] = i * i;
+        }
+        REQUIRE(table[499] == 499 * 499);
+
+        // every node is a pool block, the bucket array lives in the buddy allocator
+        REQUIRE(nodes.getAllocatedSize() == 500 * 64);
+        REQUIRE(buddy.getAllocatedSize() > 0);
+
+        for (int i = 0; i < 500; i += 2) {
+            table.erase(i);
+        }
+        REQUIRE(nodes.getAllocatedSize() == 250 * 64);
+    }
+    REQUIRE(nodes.getAllocatedSize() == 0);
+    REQUIRE(buddy.getAllocatedSize() == 0);
+
+    SECTION("Nodes larger than a pool block stay with the general allocator") {
+        allocator::pool_allocator small(8, 16);
+        std::list<double, adapter<double>> values{adapter<double>(&buddy, &small)};
+        values.push_back(1.0); // node = two links and a double
+        REQUIRE(small.getAllocatedSize() == 0);
+        REQUIRE(buddy.getAllocatedSize() > 0);
+    }
+}
+
+// Rebinding keeps the allocators, equality and propagation follow them
+TEST_CASE("AllocatorAdapter - Allocator requirements", "[allocator_adapter][traits]") {
+    allocator::buddy_allocator first(64 * 1024);
+    allocator::buddy_allocator second(64 * 1024);
+    allocator::pool_allocator nodes(32, 64);
+
+    adapter<int> a(&first, &nodes);
+    adapter<double> rebound(a);
+    REQUIRE(rebound == a);
+    REQUIRE(adapter<int>(rebound) == a);
+    REQUIRE_FALSE(adapter<int>(&first) == a);
+    REQUIRE_FALSE(adapter<int>(&second, &nodes) == a);
+
+    using traits = std::allocator_traits<adapter<int>>;
+    STATIC_REQUIRE(traits::propagate_on_container_move_assignment::value);
+    STATIC_REQUIRE(traits::propagate_on_container_swap::value);
+    STATIC_REQUIRE_FALSE(traits::is_always_equal::value);
+
+    SECTION("Move assignment and swap take the allocator along") {
+        std::vector<int, adapter<int>> left({1, 2, 3}, adapter<int>(&first));
+        std::vector<int, adapter<int>> right({4, 5}, adapter<int>(&second));
+        size_t firstUsed = first.getAllocatedSize();
+
+        left.swap(right);
+        REQUIRE(left.get_allocator() == adapter<int>(&second));
+        REQUIRE(left.front() == 4);
+
+        right = std::move(left); // right's old buffer goes back to first
+        REQUIRE(right.get_allocator() == adapter<int>(&second));
+        REQUIRE(first.getAllocatedSize() < firstUsed);
+    }
+
+    SECTION("Exhaustion throws std::bad_alloc in every build") {
+        std::vector<int, adapter<int>> values{adapter<int>(&first)};
+        REQUIRE_THROWS_AS(values.reserve(1024 * 1024), std::bad_alloc);
+    }
+}
@@ -1,5 +1,15 @@
 #include "allocator/buddy_allocator.hpp"
+#include <algorithm>
+#include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 // Allocate a block
 TEST_CASE("buddy Allocator - Allocate and deallocate blocks", "[buddy_allocator][basic]") {
@@ -135,3 +145,591 @@ TEST_CASE("buddy Allocator - Invalid deallocation", "[buddy_allocator][edge]") {
     buddyAllocator.releaseMemory();
     REQUIRE_THROWS_AS(buddyAllocator.deallocate(ptr1), std::invalid_argument);
 }
+
+// Non power-of-two buffers are carved into power-of-two roots instead of being rounded up
+TEST_CASE("buddy Allocator - Non power-of-two buffer", "[buddy_allocator][roots]") {
+    allocator::buddy_allocator buddyAllocator(96 * 1024); // 96kb buffer = 64kb + 32kb roots
+
+    void* ptr1 = buddyAllocator.allocate(64 * 1024); // whole first root
+    void* ptr2 = buddyAllocator.allocate(32 * 1024); // whole second root
+
+    REQUIRE(ptr1 != nullptr);
+    REQUIRE(ptr2 != nullptr);
+    REQUIRE(static_cast<std::byte*>(ptr2) - static_cast<std::byte*>(ptr1) == 64 * 1024);
+    REQUIRE(buddyAllocator.getAllocatedSize() == 96 * 1024);
+
+    // buffer is exhausted, the buffer was not silently rounded up to 128kb
+    REQUIRE_THROWS(buddyAllocator.allocate(1024));
+
+    buddyAllocator.deallocate(ptr1);
+    buddyAllocator.deallocate(ptr2);
+
+    // roots never coalesce with each other, so no 128kb block can appear
+    REQUIRE_THROWS(buddyAllocator.allocate(128 * 1024));
+
+    // both roots are whole again after coalescing
+    void* ptr3 = buddyAllocator.allocate(64 * 1024);
+    void* ptr4 = buddyAllocator.allocate(32 * 1024);
+    REQUIRE(ptr3 == ptr1);
+    REQUIRE(ptr4 == ptr2);
+}
+
+// Tail trimming hands the unused trailing buddies back to the free lists
+TEST_CASE("buddy Allocator - Tail trimming", "[buddy_allocator][trim]") {
+    allocator::buddy_allocator buddyAllocator(1024 * 1024,
+                                              allocator::buddy_allocator::split_policy::trim_tail);
+
+    void* ptr1 = buddyAllocator.allocate(600 * 1024); // 512kb + 64kb + 16kb + 8kb
+    REQUIRE(ptr1 != nullptr);
+    REQUIRE(buddyAllocator.getAllocatedSize() == 600 * 1024);
+
+    // the released tail is 8kb + 32kb + 128kb + 256kb
+    void* ptr2 = buddyAllocator.allocate(256 * 1024);
+    void* ptr3 = buddyAllocator.allocate(128 * 1024);
+    void* ptr4 = buddyAllocator.allocate(32 * 1024);
+    void* ptr5 = buddyAllocator.allocate(8 * 1024);
+    REQUIRE(ptr2 != nullptr);
+    REQUIRE(ptr3 != nullptr);
+    REQUIRE(ptr4 != nullptr);
+    REQUIRE(ptr5 != nullptr);
+    REQUIRE(buddyAllocator.getAllocatedSize() == 1024 * 1024);
+
+    // free the trimmed allocation in the middle of the order, the extent must still coalesce
+    buddyAllocator.deallocate(ptr3);
+    buddyAllocator.deallocate(ptr1);
+    buddyAllocator.deallocate(ptr5);
+    buddyAllocator.deallocate(ptr2);
+    buddyAllocator.deallocate(ptr4);
+    REQUIRE(buddyAllocator.getAllocatedSize() == 0);
+
+    // everything merged back into the single 1mb block
+    void* ptr6 = buddyAllocator.allocate(1024 * 1024);
+    REQUIRE(ptr6 == ptr1);
+}
+
+// Lazy coalescing keeps freed blocks cached and merges them only when needed
+TEST_CASE("buddy Allocator - Lazy coalescing", "[buddy_allocator][lazy]") {
+    allocator::buddy_allocator buddyAllocator(64 * 1024); // 64kb buffer
+    buddyAllocator.setLazyCoalescing(1000);               // never overflows in this test
+
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 64; ++i) {
+        ptrs.push_back(buddyAllocator.allocate(1024));
+    }
+
+    // freed block is reused directly from the cache
+    buddyAllocator.deallocate(ptrs[10]);
+    void* reused = buddyAllocator.allocate(1024);
+    REQUIRE(reused == ptrs[10]);
+
+    for (auto ptr : ptrs) {
+        buddyAllocator.deallocate(ptr);
+    }
+    REQUIRE(buddyAllocator.getAllocatedSize() == 0);
+
+    // cached blocks are still detected as double frees
+    REQUIRE_THROWS_AS(buddyAllocator.deallocate(ptrs[0]), std::invalid_argument);
+
+    // a larger request flushes the caches and coalesces them back into the whole buffer
+    void* whole = buddyAllocator.allocate(64 * 1024);
+    REQUIRE(whole == ptrs[0]);
+    buddyAllocator.deallocate(whole);
+
+    // overflowing a level's cache merges it immediately
+    buddyAllocator.setLazyCoalescing(1);
+    void* ptr1 = buddyAllocator.allocate(1024);
+    void* ptr2 = buddyAllocator.allocate(1024);
+    buddyAllocator.deallocate(ptr1);
+    buddyAllocator.deallocate(ptr2); // cache holds 2 > 1, level is flushed and merged
+    buddyAllocator.setLazyCoalescing(0);
+    REQUIRE(buddyAllocator.allocate(64 * 1024) == ptrs[0]);
+}
+
+// Reallocate shrinks and grows in place and only copies when it has to
+TEST_CASE("buddy Allocator - Reallocate", "[buddy_allocator][reallocate]") {
+    allocator::buddy_allocator buddyAllocator(64 * 1024); // 64kb buffer
+
+    SECTION("Shrink in place releases the upper halves") {
+        void* ptr1 = buddyAllocator.allocate(32 * 1024);
+        REQUIRE(buddyAllocator.reallocate(ptr1, 4 * 1024) == ptr1);
+        REQUIRE(buddyAllocator.getAllocatedSize() == 4 * 1024);
+
+        // the released 4kb, 8kb and 16kb halves are usable again
+        REQUIRE(buddyAllocator.allocate(16 * 1024) != nullptr);
+        REQUIRE(buddyAllocator.allocate(8 * 1024) != nullptr);
+        REQUIRE(buddyAllocator.allocate(4 * 1024) != nullptr);
+    }
+
+    SECTION("Grow in place merges with the free upper buddy") {
+        void* ptr1 = buddyAllocator.allocate(4 * 1024);
+        static_cast<char*>(ptr1)[0] = 'x';
+
+        REQUIRE(buddyAllocator.reallocate(ptr1, 16 * 1024) == ptr1);
+        REQUIRE(static_cast<char*>(ptr1)[0] == 'x');
+        REQUIRE(buddyAllocator.getAllocatedSize() == 16 * 1024);
+
+        buddyAllocator.deallocate(ptr1);
+        REQUIRE(buddyAllocator.allocate(64 * 1024) == ptr1); // everything coalesced again
+    }
+
+    SECTION("Copy when the upper buddy is taken") {
+        void* ptr1 = buddyAllocator.allocate(4 * 1024);
+        void* ptr2 = buddyAllocator.allocate(4 * 1024); // upper buddy of ptr1
+        static_cast<char*>(ptr1)[100] = 'y';
+
+        void* ptr3 = buddyAllocator.reallocate(ptr1, 8 * 1024);
+        REQUIRE(ptr3 != ptr1);
+        REQUIRE(static_cast<char*>(ptr3)[100] == 'y');
+        REQUIRE(buddyAllocator.getAllocatedSize() == 12 * 1024);
+
+        buddyAllocator.deallocate(ptr2);
+        buddyAllocator.deallocate(ptr3);
+        REQUIRE(buddyAllocator.getAllocatedSize() == 0);
+    }
+}
+
+TEST_CASE("buddy Allocator - Reallocate trimmed extents", "[buddy_allocator][reallocate][trim]") {
+    allocator::buddy_allocator buddyAllocator(1024 * 1024,
+                                              allocator::buddy_allocator::split_policy::trim_tail);
+
+    void* ptr1 = buddyAllocator.allocate(600 * 1024);
+    REQUIRE(buddyAllocator.reallocate(ptr1, 700 * 1024) == ptr1); // grows into the released tail
+    REQUIRE(buddyAllocator.reallocate(ptr1, 100 * 1024) == ptr1); // shrinks in place
+    REQUIRE(buddyAllocator.getAllocatedSize() == 100 * 1024);
+
+    buddyAllocator.deallocate(ptr1);
+    REQUIRE(buddyAllocator.allocate(1024 * 1024) == ptr1);
+}
+
+// Statistics are maintained on the hot path
+TEST_CASE("buddy Allocator - Statistics", "[buddy_allocator][stats]") {
+    allocator::buddy_allocator buddyAllocator(96 * 1024); // 64kb + 32kb roots
+
+    auto stats = buddyAllocator.getStats();
+    REQUIRE(stats.free_bytes == 96 * 1024);
+    REQUIRE(stats.largest_free_block == 64 * 1024);
+    REQUIRE(stats.free_blocks[6] == 1); // 64kb root
+    REQUIRE(stats.free_blocks[5] == 1); // 32kb root
+    REQUIRE(stats.external_fragmentation == Catch::Approx(1.0 - 64.0 / 96.0));
+
+    void* ptr1 = buddyAllocator.allocate(3000); // granted 4kb
+    REQUIRE(buddyAllocator.getObjectSize() == 4096);
+
+    stats = buddyAllocator.getStats();
+    REQUIRE(stats.allocated_bytes == 4096);
+    REQUIRE(stats.requested_bytes == 3000);
+    REQUIRE(stats.internal_fragmentation == Catch::Approx(1.0 - 3000.0 / 4096.0));
+    REQUIRE(stats.free_bytes == 92 * 1024);
+    REQUIRE(stats.largest_free_block == 64 * 1024); // split from the smaller 32kb root
+    REQUIRE(stats.free_blocks[2] == 1);             // 4kb upper buddy left from the split
+
+    buddyAllocator.deallocate(ptr1);
+    stats = buddyAllocator.getStats();
+    REQUIRE(stats.allocated_bytes == 0);
+    REQUIRE(stats.requested_bytes == 0);
+    REQUIRE(stats.free_bytes == 96 * 1024);
+    REQUIRE(stats.largest_free_block == 64 * 1024);
+}
+
+// small requests are packed into slabs carved from minimum blocks
+TEST_CASE("buddy Allocator - Small object slabs", "[buddy_allocator][slab]") {
+    allocator::buddy_allocator buddyAllocator(4 * 1024); // 4kb buffer
+
+    SECTION("Objects of one class share a minimum block") {
+        std::vector<void*> ptrs;
+        for (int i = 0; i < 64; ++i) { // 64 * 16 bytes fill exactly one 1kb slab
+            void* ptr = buddyAllocator.allocate(10);
+            REQUIRE(ptr != nullptr);
+            REQUIRE(reinterpret_cast<uintptr_t>(ptr) % 16 == 0);
+            ptrs.push_back(ptr);
+        }
+        REQUIRE(buddyAllocator.getObjectSize() == 16);
+        REQUIRE(buddyAllocator.getAllocatedSize() == 64 * 16);
+
+        auto stats = buddyAllocator.getStats();
+        REQUIRE(stats.slab_bytes == 1024);
+        REQUIRE(stats.free_bytes == 3 * 1024);
+        REQUIRE(stats.requested_bytes == 64 * 10);
+
+        for (void* ptr : ptrs) {
+            buddyAllocator.deallocate(ptr);
+        }
+
+        // the empty slab went back to the buddy tree and merged into the root
+        stats = buddyAllocator.getStats();
+        REQUIRE(stats.slab_bytes == 0);
+        REQUIRE(stats.largest_free_block == 4 * 1024);
+        REQUIRE(stats.requested_bytes == 0);
+        REQUIRE(buddyAllocator.getAllocatedSize() == 0);
+    }
+
+    SECTION("Size classes and alignment") {
+        void* ptr1 = buddyAllocator.allocate(100); // 128 byte class
+        REQUIRE(buddyAllocator.getObjectSize() == 128);
+        void* ptr2 = buddyAllocator.allocate(8, 64); // alignment moves it to the 64 byte class
+        REQUIRE(buddyAllocator.getObjectSize() == 64);
+        REQUIRE(reinterpret_cast<uintptr_t>(ptr2) % 64 == 0);
+        void* ptr3 = buddyAllocator.allocate(513); // too large for a slab, gets a whole block
+        REQUIRE(buddyAllocator.getObjectSize() == 1024);
+
+        REQUIRE(buddyAllocator.getStats().slab_bytes == 2 * 1024);
+
+        buddyAllocator.deallocate(ptr1);
+        buddyAllocator.deallocate(ptr2);
+        buddyAllocator.deallocate(ptr3);
+        REQUIRE(buddyAllocator.getStats().largest_free_block == 4 * 1024);
+    }
+
+    SECTION("Invalid and double frees are detected") {
+        auto* ptr1 = static_cast<std::byte*>(buddyAllocator.allocate(32));
+        void* ptr2 = buddyAllocator.allocate(32);
+
+        REQUIRE_THROWS_AS(buddyAllocator.deallocate(ptr1 + 8), std::invalid_argument);
+
+        buddyAllocator.deallocate(ptr1);
+        REQUIRE_THROWS_AS(buddyAllocator.deallocate(ptr1), std::invalid_argument);
+        buddyAllocator.deallocate(ptr2);
+    }
+
+    SECTION("Reallocate within and across size classes") {
+        auto* ptr = static_cast<char*>(buddyAllocator.allocate(20));
+        std::memset(ptr, 'x', 20);
+
+        REQUIRE(buddyAllocator.reallocate(ptr, 30) == ptr); // still the 32 byte class
+
+        auto* moved = static_cast<char*>(buddyAllocator.reallocate(ptr, 300));
+        REQUIRE(moved != ptr);
+        REQUIRE(moved[19] == 'x');
+        REQUIRE(buddyAllocator.getStats().requested_bytes == 300);
+
+        buddyAllocator.deallocate(moved);
+        REQUIRE(buddyAllocator.getAllocatedSize() == 0);
+    }
+}
+
+// many equal-size blocks in one call
+TEST_CASE("buddy Allocator - Batch allocation", "[buddy_allocator][batch]") {
+    allocator::buddy_allocator buddyAllocator(64 * 1024); // 64kb buffer
+
+    SECTION("Pieces of one split block are consecutive") {
+        std::vector<void*> ptrs(5);
+        REQUIRE(buddyAllocator.allocate_n(4096, 5, ptrs.data()) == 5);
+        auto* first = static_cast<std::byte*>(ptrs[0]);
+        for (size_t i = 1; i < ptrs.size(); ++i) {
+            REQUIRE(static_cast<std::byte*>(ptrs[i]) == first + 4096 * i);
+        }
+        REQUIRE(buddyAllocator.getAllocatedSize() == 5 * 4096);
+
+        // 20kb taken from the 64kb root, the rest is a 4kb, 8kb and 32kb block
+        auto stats = buddyAllocator.getStats();
+        REQUIRE(stats.free_bytes == 44 * 1024);
+        REQUIRE(stats.free_blocks[2] == 1);
+        REQUIRE(stats.free_blocks[3] == 1);
+        REQUIRE(stats.free_blocks[5] == 1);
+
+        for (void* ptr : ptrs) {
+            buddyAllocator.deallocate(ptr);
+        }
+        REQUIRE(buddyAllocator.getStats().largest_free_block == 64 * 1024);
+    }
+
+    SECTION("Partial batch when memory runs out") {
+        std::vector<void*> ptrs(8);
+        REQUIRE(buddyAllocator.allocate_n(16 * 1024, 8, ptrs.data()) == 4);
+        REQUIRE(buddyAllocator.getStats().free_bytes == 0);
+
+        for (size_t i = 0; i < 4; ++i) {
+            buddyAllocator.deallocate(ptrs[i]);
+        }
+        REQUIRE(buddyAllocator.getAllocatedSize() == 0);
+    }
+
+    SECTION("Small sizes are packed into slabs") {
+        std::vector<void*> ptrs(100);
+        REQUIRE(buddyAllocator.allocate_n(64, 100, ptrs.data()) == 100);
+        REQUIRE(buddyAllocator.getStats().slab_bytes == 7 * 1024); // 16 objects per slab
+
+        for (void* ptr : ptrs) {
+            buddyAllocator.deallocate(ptr);
+        }
+        REQUIRE(buddyAllocator.getStats().slab_bytes == 0);
+    }
+}
+
+// weighted mode grants 3*2^k extents and coalesces them like binary buddies
+TEST_CASE("buddy Allocator - Weighted size classes", "[buddy_allocator][weighted]") {
+    allocator::buddy_allocator buddyAllocator(64 * 1024,
+                                              allocator::buddy_allocator::split_policy::weighted);
+
+    auto* ptr1 = static_cast<std::byte*>(buddyAllocator.allocate(5 * 1024)); // 6kb, not 8kb
+    REQUIRE(buddyAllocator.getObjectSize() == 6 * 1024);
+    void* ptr2 = buddyAllocator.allocate(7 * 1024); // over 3/4 of 8kb, a whole block
+    REQUIRE(buddyAllocator.getObjectSize() == 8 * 1024);
+    void* ptr3 = buddyAllocator.allocate(20 * 1024); // 24kb
+    REQUIRE(buddyAllocator.getObjectSize() == 24 * 1024);
+    REQUIRE(buddyAllocator.getAllocatedSize() == 38 * 1024);
+
+    // the last quarter of the 8kb block is free and serves the next 2kb request
+    void* ptr4 = buddyAllocator.allocate(2 * 1024);
+    REQUIRE(ptr4 == ptr1 + 6 * 1024);
+
+    buddyAllocator.deallocate(ptr1);
+    buddyAllocator.deallocate(ptr3);
+    buddyAllocator.deallocate(ptr4);
+    buddyAllocator.deallocate(ptr2);
+    REQUIRE(buddyAllocator.getAllocatedSize() == 0);
+    REQUIRE(buddyAllocator.getStats().largest_free_block == 64 * 1024);
+
+    SECTION("Grow a 3*2^k extent in place") {
+        void* ptr = buddyAllocator.allocate(3 * 1024);
+        REQUIRE(buddyAllocator.reallocate(ptr, 4 * 1024) == ptr);
+        REQUIRE(buddyAllocator.reallocate(ptr, 12 * 1024) == ptr);
+        REQUIRE(buddyAllocator.getAllocatedSize() == 12 * 1024);
+        buddyAllocator.deallocate(ptr);
+        REQUIRE(buddyAllocator.getStats().largest_free_block == 64 * 1024);
+    }
+}
+
+// the slack of the rounded-up block is reported to the caller
+TEST_CASE("buddy Allocator - Allocate at least", "[buddy_allocator][at_least]") {
+    allocator::buddy_allocator buddyAllocator(64 * 1024); // 64kb buffer
+
+    auto [ptr1, size1] = buddyAllocator.allocate_at_least(3000);
+    REQUIRE(ptr1 != nullptr);
+    REQUIRE(size1 == 4096);
+
+    auto [ptr2, size2] = buddyAllocator.allocate_at_least(100); // 128 byte slab object
+    REQUIRE(size2 == 128);
+
+    SECTION("Through the STL adapter") {
+        allocator::AllocatorAdapter<int> adapter(&buddyAllocator);
+        auto [ints, count] = adapter.allocate_at_least(700); // 2800 bytes -> 4kb block
+        REQUIRE(count == 4096 / sizeof(int));
+        ints[count - 1] = 42;
+        adapter.deallocate(ints, count);
+    }
+
+    buddyAllocator.deallocate(ptr1);
+    buddyAllocator.deallocate(ptr2);
+    REQUIRE(buddyAllocator.getAllocatedSize() == 0);
+}
+
+// long-lived blocks from the low end, short-lived ones from the high end
+TEST_CASE("buddy Allocator - Lifetime hints", "[buddy_allocator][lifetime]") {
+    using lifetime = allocator::buddy_allocator::lifetime;
+    allocator::buddy_allocator buddyAllocator(1024 * 1024); // 1mb buffer
+
+    auto* longLived = static_cast<std::byte*>(buddyAllocator.allocate(4096, lifetime::long_lived));
+    auto* shortLived =
+        static_cast<std::byte*>(buddyAllocator.allocate(4096, lifetime::short_lived));
+    REQUIRE(shortLived == longLived + 1024 * 1024 - 4096);
+
+    // the next ones continue towards the middle
+    void* longLived2 = buddyAllocator.allocate(8192, lifetime::long_lived);
+    void* shortLived2 = buddyAllocator.allocate(8192, lifetime::short_lived);
+    REQUIRE(longLived2 == longLived + 8192);
+    REQUIRE(shortLived2 == shortLived - 12288);
+
+    buddyAllocator.deallocate(shortLived);
+    buddyAllocator.deallocate(shortLived2);
+    buddyAllocator.deallocate(longLived2);
+    buddyAllocator.deallocate(longLived);
+    REQUIRE(buddyAllocator.getStats().largest_free_block == 1024 * 1024);
+}
+
+#if defined(__linux__)
+// pages of a purged block no longer count towards the resident set
+TEST_CASE("buddy Allocator - Purge free blocks in mmap mode", "[buddy_allocator][purge]") {
+    using buddy = allocator::buddy_allocator;
+    buddy buddyAllocator(1024 * 1024, buddy::split_policy::whole_block, buddy::buffer_mode::mmap);
+    buddyAllocator.setPurgeThreshold(256 * 1024);
+
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    auto residentPages = [&](void* ptr, size_t size) {
+        std::vector<unsigned char> pages(size / pageSize);
+        REQUIRE(mincore(ptr, size, pages.data()) == 0);
+        return std::count_if(pages.begin(), pages.end(), [](unsigned char p) { return p & 1; });
+    };
+
+    auto* ptr = static_cast<std::byte*>(buddyAllocator.allocate(1024 * 1024));
+    std::memset(ptr, 0xab, 1024 * 1024);
+    REQUIRE(residentPages(ptr, 1024 * 1024) == static_cast<long>(1024 * 1024 / pageSize));
+
+    buddyAllocator.deallocate(ptr);
+    REQUIRE(buddyAllocator.purge() == 1024 * 1024 - pageSize);
+    REQUIRE(residentPages(ptr, 1024 * 1024) == 1); // only the free-list header page
+    REQUIRE(buddyAllocator.purge() == 0);           // already released, nothing to report
+
+    // the block is usable again, pages come back zeroed on first touch
+    auto* again = static_cast<std::byte*>(buddyAllocator.allocate(512 * 1024));
+    REQUIRE(again == ptr);
+    REQUIRE(again[pageSize] == std::byte{0});
+    std::memset(again, 0xcd, 512 * 1024);
+    buddyAllocator.deallocate(again);
+
+    // taking and splitting the block made it dirty again, the merged block is purged anew
+    REQUIRE(residentPages(ptr, 1024 * 1024) == static_cast<long>(512 * 1024 / pageSize + 1));
+    REQUIRE(buddyAllocator.purge() == 1024 * 1024 - pageSize);
+    REQUIRE(residentPages(ptr, 1024 * 1024) == 1);
+
+    SECTION("Blocks below the threshold are kept") {
+        void* small = buddyAllocator.allocate(128 * 1024);
+        buddyAllocator.deallocate(small);
+        buddyAllocator.setPurgeThreshold(2 * 1024 * 1024);
+        REQUIRE(buddyAllocator.purge() == 0);
+    }
+
+    SECTION("Purge as blocks coalesce") {
+        buddyAllocator.setPurgeThreshold(256 * 1024, true);
+        void* first = buddyAllocator.allocate(256 * 1024);
+        void* second = buddyAllocator.allocate(256 * 1024);
+        std::memset(first, 1, 256 * 1024);
+        std::memset(second, 1, 256 * 1024);
+        buddyAllocator.deallocate(first);
+        buddyAllocator.deallocate(second);
+        REQUIRE(buddyAllocator.getStats().largest_free_block == 1024 * 1024);
+
+        // lazily freed pages stay resident until reclaimed, purge() still releases them
+        REQUIRE(buddyAllocator.purge() == 1024 * 1024 - pageSize);
+        REQUIRE(residentPages(first, 1024 * 1024) == 1);
+        REQUIRE(buddyAllocator.purge() == 0);
+    }
+}
+#endif
+
+// Static interface: the inline slab path and the out-of-line path share their bookkeeping
+TEST_CASE("Buddy Allocator - Static and virtual calls", "[buddy_allocator][static]") {
+    static_assert(allocator::Allocator<allocator::buddy_allocator>);
+
+    allocator::buddy_allocator buddy(1024 * 1024);
+    allocator::AllocatorInterface& polymorphic = buddy;
+
+    struct point {
+        double x, y;
+    };
+    point* first = buddy.create<point>(1.0, 2.0);   // carves a new slab
+    point* second = buddy.create<point>(3.0, 4.0);  // partial slab hit, inline
+    void* large = polymorphic.allocate(4096);
+    REQUIRE(first != nullptr);
+    REQUIRE(second == first + 1);
+    REQUIRE(second->y == 4.0);
+    REQUIRE(buddy.getAllocatedSize() == 2 * sizeof(point) + 4096);
+
+    buddy.destroy(first);
+    buddy.destroy(second);
+    polymorphic.deallocate(large);
+    REQUIRE(buddy.getAllocatedSize() == 0);
+    REQUIRE(buddy.getStats().slab_bytes == 0);
+}
+
+// Sized deallocation skips the allocation map for slab objects and falls back otherwise
+TEST_CASE("Buddy Allocator - Sized deallocation", "[buddy_allocator][sized]") {
+    allocator::buddy_allocator buddy(1024 * 1024);
+
+    void* small = buddy.allocate(24);
+    void* aligned = buddy.allocate(24, 64);
+    void* large = buddy.allocate(3000);
+
+    buddy.deallocate(small, 24);
+    buddy.deallocate(aligned, 24, 64);
+    buddy.deallocate(large, 3000);
+    REQUIRE(buddy.getAllocatedSize() == 0);
+    REQUIRE(buddy.getStats().slab_bytes == 0);
+
+    SECTION("Double free through the sized path") {
+        void* first = buddy.allocate(24);
+        void* second = buddy.allocate(24); // keeps the slab alive
+        buddy.deallocate(first, 24);
+        REQUIRE_THROWS_AS(buddy.deallocate(first, 24), std::invalid_argument);
+        buddy.deallocate(second, 24);
+    }
+
+    SECTION("A size that does not match the allocation takes the unsized path") {
+        void* ptr = buddy.allocate(2048);
+        buddy.deallocate(ptr, 16);
+        REQUIRE(buddy.getAllocatedSize() == 0);
+    }
+
+    SECTION("AllocatorAdapter forwards the element count") {
+        {
+            std::vector<int, allocator::AllocatorAdapter<int>> values{
+                allocator::AllocatorAdapter<int>(&buddy)};
+            for (int i = 0; i < 1000; ++i) {
+                values.push_back(i); // regrowth frees slab objects and blocks by size
+            }
+            REQUIRE(values[999] == 999);
+        }
+        REQUIRE(buddy.getAllocatedSize() == 0);
+    }
+}
+
+// try_allocate reports failures as error codes instead of throwing, in every build
+TEST_CASE("Buddy Allocator - try_allocate error codes", "[buddy_allocator][try_allocate]") {
+    allocator::buddy_allocator buddy(64 * 1024);
+    allocator::AllocatorInterface& polymorphic = buddy;
+
+    auto small = buddy.try_allocate(24);
+    REQUIRE(small.has_value());
+    auto again = polymorphic.try_allocate(24); // partial slab hit
+    REQUIRE(again.value() == static_cast<std::byte*>(*small) + 32);
+
+    REQUIRE(buddy.try_allocate(128 * 1024).error() == allocator::alloc_error::size_too_large);
+    REQUIRE(buddy.try_allocate(64 * 1024).error() == allocator::alloc_error::out_of_memory);
+
+    buddy.deallocate(*small);
+    buddy.deallocate(*again);
+    auto whole = buddy.try_allocate(64 * 1024);
+    REQUIRE(whole.has_value());
+    REQUIRE(buddy.try_allocate(24).error() == allocator::alloc_error::out_of_memory);
+    buddy.deallocate(*whole);
+
+    buddy.releaseMemory();
+    REQUIRE(buddy.try_allocate(24).error() == allocator::alloc_error::no_memory);
+}
+
+// Moving hands the buffer, slabs and allocation map over, the source is left empty
+TEST_CASE("Buddy Allocator - Move and swap", "[buddy_allocator][move]") {
+    using buddy = allocator::buddy_allocator;
+    static_assert(std::is_nothrow_move_constructible_v<buddy>);
+    static_assert(std::is_nothrow_swappable_v<buddy>);
+
+    allocator::buddy_allocator source(64 * 1024);
+    void* small = source.allocate(24); // slab object
+    void* large = source.allocate(4096);
+
+    allocator::buddy_allocator moved(std::move(source));
+    REQUIRE(moved.getAllocatedSize() == 32 + 4096);
+    REQUIRE(source.getAllocatedSize() == 0);
+    REQUIRE(source.try_allocate(24).error() == allocator::alloc_error::no_memory);
+
+    // the partial slab moved along, the next object comes from it
+    void* next = moved.allocate(24);
+    REQUIRE(next == static_cast<std::byte*>(small) + 32);
+    moved.deallocate(small);
+    moved.deallocate(next);
+    moved.deallocate(large);
+    REQUIRE(moved.getAllocatedSize() == 0);
+
+    SECTION("Move assignment and swap") {
+        allocator::buddy_allocator other(128 * 1024, buddy::split_policy::trim_tail);
+        void* block = other.allocate(3000);
+        swap(moved, other);
+        moved.deallocate(block);
+        REQUIRE(moved.getStats().free_bytes == 128 * 1024);
+
+        source = std::move(other);
+        REQUIRE(source.getStats().free_bytes == 64 * 1024);
+        REQUIRE(source.allocate(60 * 1024) != nullptr);
+    }
+
+#if defined(__linux__)
+    SECTION("mmap buffers are unmapped once") {
+        allocator::buddy_allocator mapped(64 * 1024, buddy::split_policy::whole_block,
+                                          buddy::buffer_mode::mmap);
+        void* ptr = mapped.allocate(8192);
+        allocator::buddy_allocator owner(std::move(mapped));
+        std::memset(ptr, 0xab, 8192);
+        owner.deallocate(ptr);
+    }
+#endif
+}
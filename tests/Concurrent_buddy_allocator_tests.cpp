@@ -0,0 +1,109 @@
+#include "allocator/concurrent_buddy_allocator.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <thread>
+#include <vector>
+
+// Allocate a block from the caches and from the shared tree
+TEST_CASE("concurrent buddy Allocator - Allocate and deallocate blocks",
+          "[concurrent_buddy_allocator][basic]") {
+    allocator::concurrent_buddy_allocator buddyAllocator(1024 * 1024, 2); // 1mb buffer, 2 caches
+
+    void* small = buddyAllocator.allocate(4096);       // cached level
+    void* large = buddyAllocator.allocate(256 * 1024); // shared tree
+    REQUIRE(small != nullptr);
+    REQUIRE(large != nullptr);
+    REQUIRE(buddyAllocator.getAllocatedSize() == 4096 + 256 * 1024);
+
+    buddyAllocator.deallocate(small);
+    buddyAllocator.deallocate(large);
+    REQUIRE(buddyAllocator.getAllocatedSize() == 0);
+}
+
+// Invalid deallocation(e.g., double free, invalid pointer, null pointer)
+TEST_CASE("concurrent buddy Allocator - Invalid deallocation",
+          "[concurrent_buddy_allocator][edge]") {
+    allocator::concurrent_buddy_allocator buddyAllocator(1024 * 1024, 2);
+
+    void* ptr1 = buddyAllocator.allocate(4096);
+    buddyAllocator.deallocate(ptr1);
+    REQUIRE_THROWS_AS(buddyAllocator.deallocate(ptr1), std::invalid_argument); // double free
+
+    int invalidPtr;
+    REQUIRE_THROWS_AS(buddyAllocator.deallocate(&invalidPtr), std::invalid_argument);
+    REQUIRE_THROWS_AS(buddyAllocator.deallocate(nullptr), std::invalid_argument);
+}
+
+// Memory parked in the caches is drained back when the tree runs out
+TEST_CASE("concurrent buddy Allocator - Exhaustion drains the caches",
+          "[concurrent_buddy_allocator][basic]") {
+    allocator::concurrent_buddy_allocator buddyAllocator(64 * 1024, 4); // 64kb buffer
+
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 16; ++i) {
+        ptrs.push_back(buddyAllocator.allocate(4096)); // whole buffer in 4kb blocks
+    }
+    for (auto ptr : ptrs) {
+        buddyAllocator.deallocate(ptr); // parked in the caches
+    }
+
+    // needs every cached block to be merged back into the tree
+    void* whole = buddyAllocator.allocate(64 * 1024);
+    REQUIRE(whole != nullptr);
+    buddyAllocator.deallocate(whole);
+}
+
+// Requests above the cached levels go to the tree directly, and drain the caches too
+TEST_CASE("concurrent buddy Allocator - Large request drains the caches",
+          "[concurrent_buddy_allocator][basic]") {
+    allocator::concurrent_buddy_allocator buddyAllocator(1024 * 1024, 1); // 1mb buffer
+
+    void* small = buddyAllocator.allocate(1024);
+    buddyAllocator.deallocate(small); // its split siblings stay out of the tree with it
+
+    auto whole = buddyAllocator.try_allocate(1024 * 1024);
+    REQUIRE(whole.has_value());
+    buddyAllocator.deallocate(*whole);
+
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 8; ++i) {
+        ptrs.push_back(buddyAllocator.allocate(4096));
+    }
+    for (auto ptr : ptrs) {
+        buddyAllocator.deallocate(ptr);
+    }
+    void* large = buddyAllocator.allocate(512 * 1024);
+    REQUIRE(large != nullptr);
+    buddyAllocator.deallocate(large);
+}
+
+// Several threads allocating and freeing cache-sized blocks at the same time
+TEST_CASE("concurrent buddy Allocator - Multi-threaded allocations",
+          "[concurrent_buddy_allocator][threads]") {
+    allocator::concurrent_buddy_allocator buddyAllocator(16 * 1024 * 1024, 4); // 16mb buffer
+
+    auto worker = [&](int seed) {
+        std::vector<void*> ptrs;
+        for (int round = 0; round < 200; ++round) {
+            for (int i = 0; i < 16; ++i) {
+                size_t size = 4096u << ((seed + i) % 5); // 4kb .. 64kb
+                void* p = buddyAllocator.allocate(size);
+                static_cast<char*>(p)[0] = static_cast<char>(seed);
+                ptrs.push_back(p);
+            }
+            for (auto p : ptrs) {
+                buddyAllocator.deallocate(p);
+            }
+            ptrs.clear();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back(worker, t);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    REQUIRE(buddyAllocator.getAllocatedSize() == 0);
+}
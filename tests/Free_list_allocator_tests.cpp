@@ -0,0 +1,106 @@
+#include "allocator/free_list_allocator.hpp"
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cstring>
+#include <vector>
+
+using fit_policy = allocator::free_list_allocator::fit_policy;
+
+// Freed neighbours are merged right away through the boundary tags
+TEST_CASE("free list Allocator - Coalescing", "[free_list_allocator][coalesce]") {
+    allocator::free_list_allocator freeList(64 * 1024); // 64kb buffer
+
+    void* ptr1 = freeList.allocate(16 * 1024);
+    void* ptr2 = freeList.allocate(16 * 1024);
+    void* ptr3 = freeList.allocate(16 * 1024);
+    REQUIRE(ptr3 != nullptr);
+    REQUIRE(freeList.getFreeBlockCount() == 1); // the tail
+
+    freeList.deallocate(ptr1);
+    freeList.deallocate(ptr3); // merges with the tail
+    REQUIRE(freeList.getFreeBlockCount() == 2);
+
+    // the middle one merges with the previous and the next block at once
+    freeList.deallocate(ptr2);
+    REQUIRE(freeList.getFreeBlockCount() == 1);
+
+    // the whole buffer minus the end markers and the block's own tags
+    void* whole = freeList.allocate(64 * 1024 - 32);
+    REQUIRE(whole == ptr1);
+    freeList.deallocate(whole);
+
+    SECTION("Alignment gaps") {
+        // an over-aligned payload leaves a free block in front of it, merged back on free
+        void* aligned = freeList.allocate(100, 4096);
+        REQUIRE(reinterpret_cast<uintptr_t>(aligned) % 4096 == 0);
+        REQUIRE(freeList.getFreeBlockCount() == 2);
+        freeList.deallocate(aligned);
+        REQUIRE(freeList.getFreeBlockCount() == 1);
+    }
+}
+
+// Placement of each policy on the same set of holes
+TEST_CASE("free list Allocator - Fit policies", "[free_list_allocator][policy]") {
+    // free blocks of 512, 128 and 256 bytes, separated by live blocks
+    auto make_holes = [](allocator::free_list_allocator& freeList, std::vector<void*>& holes) {
+        std::vector<void*> guards;
+        for (size_t size : {512, 128, 256}) {
+            holes.push_back(freeList.allocate(size - 16));
+            guards.push_back(freeList.allocate(16));
+        }
+        for (void* hole : holes) {
+            freeList.deallocate(hole);
+        }
+    };
+
+    SECTION("First fit") {
+        allocator::free_list_allocator freeList(64 * 1024, fit_policy::first_fit);
+        std::vector<void*> holes;
+        make_holes(freeList, holes);
+        // the list is LIFO, so the first hole large enough is the last one freed
+        REQUIRE(freeList.allocate(100) == holes[2]);
+    }
+
+    SECTION("Best fit") {
+        allocator::free_list_allocator freeList(64 * 1024, fit_policy::best_fit);
+        std::vector<void*> holes;
+        make_holes(freeList, holes);
+        REQUIRE(freeList.allocate(100) == holes[1]);
+        REQUIRE(freeList.allocate(200) == holes[2]);
+        REQUIRE(freeList.allocate(400) == holes[0]);
+    }
+
+    SECTION("Next fit") {
+        allocator::free_list_allocator freeList(64 * 1024, fit_policy::next_fit);
+        std::vector<void*> holes;
+        make_holes(freeList, holes);
+        // the search resumes at the tail the last allocation split, the holes are skipped
+        void* first = freeList.allocate(100);
+        void* second = freeList.allocate(100);
+        REQUIRE(std::find(holes.begin(), holes.end(), first) == holes.end());
+        REQUIRE(second == static_cast<std::byte*>(first) + 128);
+    }
+}
+
+// An interior pointer whose payload bytes look like an allocated header is caught by the footer
+TEST_CASE("free list Allocator - Interior pointers", "[free_list_allocator][footer]") {
+    allocator::free_list_allocator freeList(64 * 1024);
+    auto* ptr = static_cast<std::byte*>(freeList.allocate(240)); // a 256 byte block
+
+    // the word before ptr + 64 claims an allocated 64 byte block, its footer does not match
+    size_t fakeHeader = 64 | 1;
+    size_t fakeFooter = 0;
+    std::memcpy(ptr + 56, &fakeHeader, sizeof(size_t));
+    std::memcpy(ptr + 112, &fakeFooter, sizeof(size_t));
+    REQUIRE_THROWS_AS(freeList.deallocate(ptr + 64), std::invalid_argument);
+
+    // off the 16 byte grid, and outside the buffer
+    int outside = 0;
+    REQUIRE_THROWS_AS(freeList.deallocate(ptr + 8), std::invalid_argument);
+    REQUIRE_THROWS_AS(freeList.deallocate(&outside), std::invalid_argument);
+
+    // the block itself is untouched
+    freeList.deallocate(ptr);
+    REQUIRE(freeList.getAllocatedSize() == 0);
+    REQUIRE(freeList.getFreeBlockCount() == 1);
+}
@@ -0,0 +1,263 @@
+#include "allocator/buddy_allocator.hpp"
+#include "allocator/memory_provider.hpp"
+#include "allocator/pool_allocator.hpp"
+#include "allocator/slab_allocator.hpp"
+#include "allocator/stack_allocator.hpp"
+#include "allocator/tlsf_allocator.hpp"
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+using buddy = allocator::buddy_allocator;
+
+bool is_aligned(void* ptr, size_t alignment) {
+    return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+// counts what goes through it, memory from operator new
+class counting_provider final : public allocator::memory_provider {
+  public:
+    void* acquire(size_t size, size_t alignment) noexcept override {
+        ++acquired;
+        bytes += size;
+        return inner.acquire(size, alignment);
+    }
+    void release(void* ptr, size_t size, size_t alignment) noexcept override {
+        ++released;
+        bytes -= size;
+        inner.release(ptr, size, alignment);
+    }
+
+    allocator::new_delete_provider inner;
+    size_t acquired = 0;
+    size_t released = 0;
+    size_t bytes = 0;
+};
+} // namespace
+
+// Every provider hands out usable ranges aligned as asked
+TEST_CASE("memory provider - Acquire and release", "[memory_provider][basic]") {
+    allocator::new_delete_provider heap;
+    allocator::mmap_provider pages;
+    allocator::mmap_provider huge(allocator::mmap_provider::pages::huge);
+    std::vector<allocator::memory_provider*> providers{&heap};
+#if defined(__unix__) || defined(__APPLE__)
+    providers.push_back(&pages);
+    providers.push_back(&huge);
+#endif
+
+    for (auto* provider : providers) {
+        for (size_t alignment : {size_t{16}, size_t{4096}, size_t{64 * 1024}}) {
+            auto* ptr = static_cast<std::byte*>(provider->acquire(100 * 1024, alignment));
+            REQUIRE(ptr != nullptr);
+            REQUIRE(is_aligned(ptr, alignment));
+            std::memset(ptr, 0xab, 100 * 1024);
+            provider->release(ptr, 100 * 1024, alignment);
+        }
+    }
+}
+
+// Ranges are carved front to back, the last one goes back on release
+TEST_CASE("memory provider - Caller-supplied buffer", "[memory_provider][buffer]") {
+    alignas(64) static std::byte arena[64 * 1024];
+    allocator::buffer_provider provider(arena, sizeof(arena));
+
+    void* first = provider.acquire(1000, 16);
+    void* second = provider.acquire(1000, 64);
+    REQUIRE(first == arena);
+    REQUIRE(is_aligned(second, 64));
+    REQUIRE(provider.getUsedSize() == 1024 + 1000);
+    REQUIRE(provider.acquire(64 * 1024, 16) == nullptr);
+
+    provider.release(second, 1000, 64);
+    REQUIRE(provider.getUsedSize() == 1024);
+    provider.release(first, 1000, 16); // the alignment padding above it is still used
+    REQUIRE(provider.getUsedSize() == 1024);
+    provider.reset();
+    REQUIRE(provider.getUsedSize() == 0);
+
+    SECTION("Allocators on a static arena") {
+        {
+            allocator::pool_allocator pool(64, 100, 0, 2, &provider);
+            allocator::stack_allocator stack(8 * 1024, 0, false, &provider);
+            void* block = pool.allocate();
+            void* chunk = stack.allocate(100);
+            REQUIRE(block >= arena + 0);
+            REQUIRE(block < arena + sizeof(arena));
+            REQUIRE(chunk >= arena + 0);
+            REQUIRE(chunk < arena + sizeof(arena));
+            pool.deallocate(block);
+        }
+        // the stack went back first and the pool's range is now the top
+        REQUIRE(provider.getUsedSize() == 0);
+    }
+
+    SECTION("Exhaustion surfaces through the allocator") {
+        allocator::stack_allocator stack(24 * 1024, 0, true, &provider);
+        REQUIRE(stack.allocate(24 * 1024) != nullptr);
+        REQUIRE(stack.allocate(24 * 1024) != nullptr); // a second buffer, 16KB of arena left
+        REQUIRE(stack.try_allocate(24 * 1024).error() == allocator::alloc_error::out_of_memory);
+        REQUIRE_THROWS_AS(buddy(128 * 1024, buddy::split_policy::whole_block,
+                                buddy::buffer_mode::heap, &provider),
+                          std::bad_alloc);
+    }
+}
+
+// Every buffer, pool and slab goes through the provider and comes back to it
+TEST_CASE("memory provider - Allocators use the injected provider", "[memory_provider][inject]") {
+    counting_provider provider;
+
+    {
+        allocator::pool_allocator pool(32, 16, 0, 4, &provider);
+        std::vector<void*> blocks;
+        for (int i = 0; i < 40; ++i) {
+            blocks.push_back(pool.allocate()); // grows into 3 pools
+        }
+        REQUIRE(provider.acquired == 3);
+        REQUIRE(provider.bytes == 3 * 32 * 16);
+        for (void* block : blocks) {
+            pool.deallocate(block);
+        }
+    }
+    REQUIRE(provider.released == 3);
+
+    {
+        buddy buddyAllocator(256 * 1024, buddy::split_policy::whole_block,
+                             buddy::buffer_mode::heap, &provider);
+        allocator::tlsf_allocator tlsf(64 * 1024, &provider);
+        allocator::slab_allocator slab(48, 0, {}, {}, allocator::slab_allocator::KEEP_ALL_EMPTY,
+                                       &provider);
+        void* object = slab.allocate(48);
+        REQUIRE(is_aligned(buddyAllocator.allocate(4096), 4096));
+        REQUIRE(tlsf.allocate(100) != nullptr);
+        REQUIRE(provider.bytes == 256 * 1024 + 64 * 1024 + 4096);
+        slab.deallocate(object);
+
+        // moving keeps the provider, the buffer is released through it once
+        buddy moved(std::move(buddyAllocator));
+    }
+    REQUIRE(provider.bytes == 0);
+    REQUIRE(provider.acquired == provider.released);
+}
+
+// An allocator can be backed by another allocator's memory
+TEST_CASE("memory provider - Upstream allocator", "[memory_provider][upstream]") {
+    allocator::buddy_allocator upstream(1024 * 1024);
+    allocator::upstream_provider provider(upstream);
+
+    {
+        allocator::pool_allocator pool(64, 64, 0, 2, &provider);
+        allocator::stack_allocator stack(16 * 1024, 0, false, &provider);
+        REQUIRE(upstream.getAllocatedSize() >= 64 * 64 + 16 * 1024);
+        void* block = pool.allocate();
+        REQUIRE(block != nullptr);
+        pool.deallocate(block);
+    }
+    REQUIRE(upstream.getAllocatedSize() == 0);
+
+    // buddy blocks are aligned to their size within a page aligned buffer
+    void* ptr = provider.acquire(4096, 4096);
+    REQUIRE(is_aligned(ptr, 4096));
+    provider.release(ptr, 4096, 4096);
+    REQUIRE(provider.acquire(2 * 1024 * 1024, 16) == nullptr);
+}
+
+#if defined(__linux__)
+// Backing buffers are not initialized, construction leaves their pages untouched
+TEST_CASE("memory provider - Construction does not fault in buffers", "[memory_provider][rss]") {
+    auto residentBytes = [] {
+        size_t total = 0, resident = 0;
+        std::ifstream("/proc/self/statm") >> total >> resident;
+        return resident * allocator::memory_provider::page_size();
+    };
+    constexpr size_t MB = 1024 * 1024;
+
+    size_t before = residentBytes();
+    allocator::stack_allocator stack(64 * MB);
+    allocator::pool_allocator pool(64, MB); // 64MB of blocks
+    buddy buddyAllocator(128 * MB);
+    REQUIRE(residentBytes() - before < 32 * MB); // bookkeeping only, not 256MB of buffers
+
+    // blocks are still carved and recycled as before
+    void* first = pool.allocate();
+    void* second = pool.allocate();
+    REQUIRE(static_cast<std::byte*>(second) - static_cast<std::byte*>(first) == 64);
+    pool.deallocate(first);
+    REQUIRE(pool.allocate() == first);
+}
+
+// Purging drops the pages of a range, which stays mapped and reads back as zero
+TEST_CASE("memory provider - Purge mmap ranges", "[memory_provider][purge]") {
+    allocator::mmap_provider provider;
+    const size_t pageSize = allocator::memory_provider::page_size();
+    const size_t size = 64 * pageSize;
+
+    auto residentPages = [&](void* ptr) {
+        std::vector<unsigned char> pages(size / pageSize);
+        REQUIRE(mincore(ptr, size, pages.data()) == 0);
+        return std::count_if(pages.begin(), pages.end(), [](unsigned char p) { return p & 1; });
+    };
+
+    auto* ptr = static_cast<std::byte*>(provider.acquire(size, pageSize));
+    REQUIRE(residentPages(ptr) == 0); // nothing is backed before it is touched
+    std::memset(ptr, 0xab, size);
+    REQUIRE(residentPages(ptr) == 64);
+
+    REQUIRE(provider.purge(ptr, size, false) == size);
+    REQUIRE(residentPages(ptr) == 0);
+    REQUIRE(ptr[size - 1] == std::byte{0});
+    provider.release(ptr, size, pageSize);
+
+    SECTION("Heap memory cannot be purged") {
+        allocator::new_delete_provider heap;
+        void* block = heap.acquire(size, pageSize);
+        REQUIRE(heap.purge(block, size, false) == 0);
+        heap.release(block, size, pageSize);
+    }
+}
+
+// Ranges are files whose descriptor maps the same memory a second time
+TEST_CASE("memory provider - memfd shared mappings", "[memory_provider][memfd]") {
+    allocator::memfd_provider provider("memory_provider_tests");
+    const size_t size = 256 * 1024;
+
+    auto* ptr = static_cast<std::byte*>(provider.acquire(size, 64 * 1024));
+    REQUIRE(ptr != nullptr);
+    REQUIRE(is_aligned(ptr, 64 * 1024));
+    int fd = provider.getFileDescriptor(ptr);
+    REQUIRE(fd >= 0);
+    REQUIRE(provider.getFileDescriptor(ptr + 1) == -1);
+
+    void* view = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    REQUIRE(view != MAP_FAILED);
+    ptr[1000] = std::byte{42};
+    REQUIRE(static_cast<std::byte*>(view)[1000] == std::byte{42});
+
+    // purging frees the file pages, both views see zeroes
+    REQUIRE(provider.purge(ptr, size, false) == size);
+    REQUIRE(static_cast<std::byte*>(view)[1000] == std::byte{0});
+    munmap(view, size);
+
+    SECTION("A buddy allocator in shared memory") {
+        buddy buddyAllocator(1024 * 1024, buddy::split_policy::whole_block,
+                             buddy::buffer_mode::heap, &provider);
+        buddyAllocator.setPurgeThreshold(256 * 1024);
+        void* block = buddyAllocator.allocate(512 * 1024);
+        std::memset(block, 1, 512 * 1024);
+        buddyAllocator.deallocate(block);
+        REQUIRE(buddyAllocator.purge() > 0);
+    }
+
+    provider.release(ptr, size, 64 * 1024);
+    REQUIRE(provider.getFileDescriptor(ptr) == -1);
+}
+#endif
@@ -0,0 +1,97 @@
+#include "allocator/buddy_allocator.hpp"
+#include "allocator/pmr_resource.hpp"
+#include "allocator/pool_allocator.hpp"
+#include "allocator/stack_allocator.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <list>
+#include <string>
+#include <vector>
+
+// std::pmr containers on the buddy allocator
+TEST_CASE("pmr resource - Containers on buddy allocator", "[pmr_resource][buddy]") {
+    allocator::buddy_allocator buddy(1024 * 1024);
+    allocator::pmr_resource resource(buddy);
+
+    {
+        std::pmr::vector<int> values(&resource);
+        std::pmr::string text("a string long enough to leave the small buffer", &resource);
+        for (int i = 0; i < 1000; ++i) {
+            values.push_back(i);
+        }
+        REQUIRE(values[999] == 999);
+        REQUIRE(buddy.getAllocatedSize() > 0);
+        REQUIRE(resource.getUpstreamCount() == 0);
+    }
+    REQUIRE(buddy.getAllocatedSize() == 0);
+
+    // alignment is honoured, slab objects are aligned to their size class
+    void* ptr = resource.allocate(100, 64);
+    REQUIRE(reinterpret_cast<uintptr_t>(ptr) % 64 == 0);
+    resource.deallocate(ptr, 100, 64);
+    REQUIRE(buddy.getAllocatedSize() == 0);
+}
+
+// Requests the pool cannot serve go upstream and come back there
+TEST_CASE("pmr resource - Upstream fallback on pool allocator", "[pmr_resource][pool]") {
+    allocator::pool_allocator pool(32, 4); // a single pool of 4 blocks
+    allocator::pmr_resource resource(pool, std::pmr::new_delete_resource());
+
+    SECTION("Exhausted pool") {
+        {
+            std::pmr::list<int> values(&resource);
+            for (int i = 0; i < 10; ++i) {
+                values.push_back(i);
+            }
+            REQUIRE(pool.getAllocatedSize() == 4 * 32);
+            REQUIRE(resource.getUpstreamCount() == 6);
+        }
+        REQUIRE(pool.getAllocatedSize() == 0);
+        REQUIRE(resource.getUpstreamCount() == 0);
+    }
+
+    SECTION("Larger than a block or more aligned than the pool") {
+        void* large = resource.allocate(64);
+        void* aligned = resource.allocate(16, 64);
+        REQUIRE(reinterpret_cast<uintptr_t>(aligned) % 64 == 0);
+        REQUIRE(resource.getUpstreamCount() >= 1);
+
+        resource.deallocate(large, 64);
+        resource.deallocate(aligned, 16, 64);
+        REQUIRE(pool.getAllocatedSize() == 0);
+        REQUIRE(resource.getUpstreamCount() == 0);
+    }
+
+    SECTION("Null upstream reports exhaustion") {
+        allocator::pmr_resource strict(pool, std::pmr::null_memory_resource());
+        REQUIRE_THROWS_AS(strict.allocate(64), std::bad_alloc);
+    }
+}
+
+// The stack releases in bulk, container frees are ignored
+TEST_CASE("pmr resource - Stack allocator as a monotonic resource", "[pmr_resource][stack]") {
+    allocator::stack_allocator stack(64 * 1024);
+    allocator::pmr_resource resource(stack);
+
+    {
+        std::pmr::vector<std::pmr::string> names(&resource);
+        for (int i = 0; i < 20; ++i) {
+            names.emplace_back("name long enough to need its own allocation " + std::to_string(i));
+        }
+        REQUIRE(names[19].back() == '9');
+    }
+    REQUIRE(stack.getAllocatedSize() > 0);
+
+    stack.reset();
+    REQUIRE(stack.getAllocatedSize() == 0);
+}
+
+// Each resource keeps its own record of upstream blocks, so only identity compares equal
+TEST_CASE("pmr resource - Equality", "[pmr_resource][equality]") {
+    allocator::buddy_allocator buddy(64 * 1024);
+    allocator::pmr_resource first(buddy);
+    allocator::pmr_resource second(buddy);
+
+    REQUIRE(first == first);
+    REQUIRE_FALSE(first == second);
+    REQUIRE_FALSE(first.is_equal(*std::pmr::new_delete_resource()));
+}
@@ -156,4 +156,130 @@ TEST_CASE("Pool Allocator - alignment must be between alignof(int) and alignof(m
           "[alignment]") {
     REQUIRE_THROWS_AS(allocator::pool_allocator(16, 32, 3), std::invalid_argument);
     REQUIRE_THROWS_AS(allocator::pool_allocator(16, 32, 20), std::invalid_argument);
-}
\ No newline at end of file
+}
+// Static interface: the concrete type models allocator::Allocator and agrees with virtual calls
+TEST_CASE("Pool Allocator - Static and virtual calls share the pool", "[pool_allocator][static]") {
+    static_assert(allocator::Allocator<allocator::pool_allocator>);
+
+    allocator::pool_allocator poolAllocator(sizeof(double), 4, 0, 2);
+    allocator::AllocatorInterface& polymorphic = poolAllocator;
+
+    double* value = poolAllocator.create<double>(1.5);
+    void* block = polymorphic.allocate(sizeof(double));
+    REQUIRE(value != nullptr);
+    REQUIRE(*value == 1.5);
+    REQUIRE(poolAllocator.getAllocatedSize() == 2 * sizeof(double));
+
+    // blocks of the second pool are freed through the slow path
+    std::vector<void*> blocks;
+    for (int i = 0; i < 4; ++i) {
+        blocks.push_back(poolAllocator.allocate());
+    }
+    for (void* ptr : blocks) {
+        polymorphic.deallocate(ptr);
+    }
+
+    poolAllocator.destroy(value);
+    poolAllocator.deallocate(block);
+    REQUIRE(poolAllocator.getAllocatedSize() == 0);
+}
+
+// try_allocate reports failures as error codes instead of throwing, in every build
+TEST_CASE("Pool Allocator - try_allocate error codes", "[pool_allocator][try_allocate]") {
+    allocator::pool_allocator poolAllocator(32, 2); // a single pool of two blocks
+
+    auto first = poolAllocator.try_allocate(32);
+    auto second = poolAllocator.try_allocate(16);
+    REQUIRE(first.has_value());
+    REQUIRE(second.has_value());
+
+    auto exhausted = poolAllocator.try_allocate(32);
+    REQUIRE_FALSE(exhausted.has_value());
+    REQUIRE(exhausted.error() == allocator::alloc_error::capacity_exceeded);
+
+    auto tooLarge = poolAllocator.try_allocate(64);
+    REQUIRE(tooLarge.error() == allocator::alloc_error::size_too_large);
+
+    poolAllocator.deallocate(*first);
+    REQUIRE(poolAllocator.try_allocate(32).value() == *first);
+
+    poolAllocator.releaseMemory();
+    REQUIRE(poolAllocator.try_allocate(32).error() == allocator::alloc_error::no_memory);
+}
+
+// The check policy picks the validation of deallocate at compile time
+TEST_CASE("Pool Allocator - Deallocation check policies", "[pool_allocator][policy]") {
+    using allocator::check_policy;
+    allocator::pool_allocator poolAllocator(32, 4, 0, 2);
+
+    void* first = poolAllocator.allocate();
+    void* second = poolAllocator.allocate();
+
+    // paranoid walks the free list, checked only looks at where the pointer is
+    poolAllocator.deallocate<check_policy::paranoid>(first);
+    REQUIRE_THROWS_AS(poolAllocator.deallocate<check_policy::paranoid>(first), std::runtime_error);
+    REQUIRE_THROWS_AS(poolAllocator.deallocate<check_policy::checked>(nullptr),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(poolAllocator.deallocate<check_policy::checked>(
+                          static_cast<std::byte*>(second) + 8),
+                      std::runtime_error);
+
+    // unchecked trusts the pointer, here a valid one of the second pool
+    std::vector<void*> blocks;
+    for (int i = 0; i < 5; ++i) {
+        blocks.push_back(poolAllocator.allocate());
+    }
+    REQUIRE(poolAllocator.getAllocatedSize() == 6 * 32);
+    for (void* ptr : blocks) {
+        poolAllocator.deallocate<check_policy::unchecked>(ptr);
+    }
+    poolAllocator.deallocate<check_policy::unchecked>(second);
+    REQUIRE(poolAllocator.getAllocatedSize() == 0);
+}
+
+// Moving hands the pools over, live blocks stay valid and the source is left empty
+TEST_CASE("Pool Allocator - Move and swap", "[pool_allocator][move]") {
+    allocator::pool_allocator source(32, 4);
+    int* value = static_cast<int*>(source.allocate());
+    *value = 42;
+
+    allocator::pool_allocator moved(std::move(source));
+    REQUIRE(*value == 42);
+    REQUIRE(moved.getAllocatedSize() == 32);
+    REQUIRE(source.getAllocatedSize() == 0);
+    REQUIRE(source.try_allocate(32).error() == allocator::alloc_error::no_memory);
+    moved.deallocate(value);
+
+    // the moved-from allocator gets a fresh pool on reset
+    source.reset();
+    REQUIRE(source.allocate() != nullptr);
+
+    SECTION("Swap exchanges the pools") {
+        allocator::pool_allocator other(64, 2);
+        void* block = other.allocate();
+        swap(moved, other);
+        REQUIRE(moved.getObjectSize() == 64);
+        REQUIRE(moved.getAllocatedSize() == 64);
+        moved.deallocate(block);
+        REQUIRE(other.getObjectSize() == 32);
+    }
+
+    SECTION("Pools held by value in a vector") {
+        std::vector<allocator::pool_allocator> arenas;
+        for (int i = 0; i < 8; ++i) {
+            arenas.emplace_back(16, 8); // regrowth moves the allocators
+        }
+        void* block = arenas.front().allocate();
+        arenas.emplace_back(std::move(moved));
+        arenas.front().deallocate(block);
+        REQUIRE(arenas.back().getObjectSize() == 32);
+    }
+
+    SECTION("Move assignment frees the target's old pools") {
+        allocator::pool_allocator target(128, 2);
+        [[maybe_unused]] void* lost = target.allocate();
+        target = std::move(moved);
+        REQUIRE(target.getObjectSize() == 32);
+        REQUIRE(target.getAllocatedSize() == 0);
+    }
+}
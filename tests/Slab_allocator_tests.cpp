@@ -0,0 +1,156 @@
+#include "allocator/slab_allocator.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <new>
+#include <vector>
+
+namespace {
+struct connection {
+    int id;
+    char buffer[100];
+};
+} // namespace
+
+// Allocate and free objects
+TEST_CASE("slab Allocator - Allocate and deallocate objects", "[slab_allocator][basic]") {
+    allocator::slab_allocator slabs(sizeof(connection), alignof(connection));
+    REQUIRE(slabs.getSlabCount() == 0); // slabs are created on demand
+
+    void* ptr1 = slabs.allocate();
+    void* ptr2 = slabs.allocate(sizeof(connection));
+    REQUIRE(ptr1 != nullptr);
+    REQUIRE(ptr2 != nullptr);
+    REQUIRE(ptr1 != ptr2);
+    REQUIRE(slabs.getSlabCount() == 1);
+    REQUIRE(slabs.getAllocatedSize() == 2 * slabs.getObjectSize());
+
+    slabs.deallocate(ptr1);
+    slabs.deallocate(ptr2);
+    REQUIRE(slabs.getAllocatedSize() == 0);
+    REQUIRE(slabs.getSlabCount() == 1); // one empty slab stays cached
+}
+
+// Constructors run once per slot, not once per allocation
+TEST_CASE("slab Allocator - Constructed state is retained", "[slab_allocator][ctor]") {
+    int constructed = 0;
+    int destroyed = 0;
+
+    {
+        allocator::slab_allocator slabs(
+            sizeof(connection), alignof(connection),
+            [&](void* p) {
+                ++constructed;
+                static_cast<connection*>(p)->id = 42;
+            },
+            [&](void*) { ++destroyed; });
+
+        const int perSlab = static_cast<int>(slabs.getObjectsPerSlab());
+
+        auto* c = static_cast<connection*>(slabs.allocate());
+        REQUIRE(constructed == perSlab); // the whole slab was constructed up front
+        REQUIRE(c->id == 42);
+
+        // state set by a user survives free and allocate
+        c->id = 7;
+        slabs.deallocate(c);
+        auto* again = static_cast<connection*>(slabs.allocate());
+        REQUIRE(again == c);
+        REQUIRE(again->id == 7);
+        REQUIRE(constructed == perSlab);
+        slabs.deallocate(again);
+
+        // reaping an empty slab destroys its objects
+        REQUIRE(slabs.reap() == 1);
+        REQUIRE(destroyed == perSlab);
+        REQUIRE(slabs.getSlabCount() == 0);
+
+        (void) slabs.allocate(); // a fresh slab, destroyed with the allocator
+    }
+    REQUIRE(constructed == destroyed);
+}
+
+// A constructor that throws undoes its slab, allocate rethrows and try_allocate reports it
+TEST_CASE("slab Allocator - Throwing constructor", "[slab_allocator][ctor]") {
+    int calls = 0;
+    int constructed = 0;
+    int destroyed = 0;
+    int failAt = 5; // the constructor call that throws, 0 for none
+
+    {
+        allocator::slab_allocator slabs(
+            sizeof(connection), alignof(connection),
+            [&](void*) {
+                if (++calls == failAt) {
+                    throw std::bad_alloc();
+                }
+                ++constructed;
+            },
+            [&](void*) { ++destroyed; });
+
+        REQUIRE_THROWS_AS(slabs.allocate(), std::bad_alloc);
+        REQUIRE(destroyed == 4); // only the slots built before the failure
+        REQUIRE(slabs.getSlabCount() == 0);
+        REQUIRE(slabs.getAllocatedSize() == 0);
+
+        failAt = calls + 3;
+        auto result = slabs.try_allocate();
+        REQUIRE(!result);
+        REQUIRE(result.error() == allocator::alloc_error::out_of_memory);
+        REQUIRE(destroyed == 6);
+
+        failAt = 0;
+        void* ptr = slabs.allocate();
+        REQUIRE(ptr != nullptr);
+        REQUIRE(slabs.getSlabCount() == 1);
+        slabs.deallocate(ptr);
+    }
+    REQUIRE(constructed == destroyed);
+}
+
+// Full, partial and empty lists
+TEST_CASE("slab Allocator - Slab lists", "[slab_allocator][lists]") {
+    allocator::slab_allocator slabs(64, 0, {}, {}, 0); // keep no empty slab
+    const size_t perSlab = slabs.getObjectsPerSlab();
+
+    std::vector<void*> ptrs;
+    for (size_t i = 0; i < perSlab + 1; ++i) {
+        ptrs.push_back(slabs.allocate());
+    }
+    REQUIRE(slabs.getSlabCount() == 2); // one full, one partial
+
+    // freeing one object of the full slab makes it partial, it is reused before anything else
+    slabs.deallocate(ptrs[3]);
+    REQUIRE(slabs.allocate() == ptrs[3]);
+
+    // emptying the second slab reclaims it right away
+    slabs.deallocate(ptrs.back());
+    REQUIRE(slabs.getSlabCount() == 1);
+
+    slabs.reset();
+    REQUIRE(slabs.getAllocatedSize() == 0);
+    REQUIRE(slabs.getSlabCount() == 1);
+}
+
+// Invalid requests and frees
+TEST_CASE("slab Allocator - Edge cases", "[slab_allocator][edge]") {
+    REQUIRE_THROWS_AS(allocator::slab_allocator(0), std::invalid_argument);
+    REQUIRE_THROWS_AS(allocator::slab_allocator(64, 3), std::invalid_argument);
+
+    allocator::slab_allocator slabs(64);
+    void* ptr = slabs.allocate();
+    int outside = 0;
+
+#if ALLOCATOR_DEBUG
+    REQUIRE_THROWS(slabs.allocate(128));
+#else
+    REQUIRE(slabs.allocate(128) == nullptr);
+#endif
+    REQUIRE_THROWS_AS(slabs.deallocate(nullptr), std::invalid_argument);
+    REQUIRE_THROWS_AS(slabs.deallocate(&outside), std::invalid_argument);
+    REQUIRE_THROWS_AS(slabs.deallocate(static_cast<std::byte*>(ptr) + 8), std::invalid_argument);
+
+    slabs.deallocate(ptr);
+    REQUIRE_THROWS_AS(slabs.deallocate(ptr), std::invalid_argument); // double free
+
+    slabs.releaseMemory();
+    REQUIRE(slabs.getSlabCount() == 0);
+}
@@ -373,3 +373,113 @@ TEST_CASE("stack_allocator - Pass alignment is more than alignof(max_align_t) us
 
     REQUIRE(stackAllocator.getObjectSize() == 128); // 127 padding, too much internal fragmentation
 }
+
+// Static interface: the concrete type models allocator::Allocator and agrees with virtual calls
+TEST_CASE("stack_allocator - Static and virtual calls share the stack",
+          "[stack_allocator][static]") {
+    static_assert(allocator::Allocator<allocator::stack_allocator>);
+
+    allocator::stack_allocator stackAllocator(64);
+    allocator::AllocatorInterface& polymorphic = stackAllocator;
+
+    double* value = stackAllocator.create<double>(4.5);
+    void* chunk = polymorphic.allocate(20);
+    REQUIRE(*value == 4.5);
+    REQUIRE(static_cast<std::byte*>(chunk) == reinterpret_cast<std::byte*>(value) + 8);
+    REQUIRE(stackAllocator.getAllocatedSize() == 8 + 24);
+
+    // explicit alignment takes the out-of-line path
+    void* aligned = stackAllocator.allocate(4, 16);
+    REQUIRE(stackAllocator.getAllocatedSize() == 8 + 24 + 16);
+
+    stackAllocator.deallocate(aligned);
+    polymorphic.deallocate(chunk);
+    stackAllocator.destroy(value);
+    REQUIRE(stackAllocator.getAllocatedSize() == 0);
+}
+
+// try_allocate reports failures as error codes instead of throwing, in every build
+TEST_CASE("stack_allocator - try_allocate error codes", "[stack_allocator][try_allocate]") {
+    allocator::stack_allocator stackAllocator(64);
+
+    auto chunk = stackAllocator.try_allocate(48);
+    REQUIRE(chunk.has_value());
+    REQUIRE(stackAllocator.try_allocate(32).error() == allocator::alloc_error::capacity_exceeded);
+    REQUIRE(stackAllocator.try_allocate(128).error() == allocator::alloc_error::size_too_large);
+    REQUIRE(stackAllocator.try_allocate(8, 3).error() ==
+            allocator::alloc_error::invalid_alignment);
+
+    // allocate still reports a bad alignment as an invalid argument
+    REQUIRE_THROWS_AS(stackAllocator.allocate(8, 3), std::invalid_argument);
+
+    SECTION("Resizable stacks grow until the 64 MB cap") {
+        allocator::stack_allocator resizable(32 * 1024 * 1024, 0, true);
+        REQUIRE(resizable.try_allocate(32 * 1024 * 1024).has_value());
+        REQUIRE(resizable.try_allocate(32 * 1024 * 1024).has_value());
+        REQUIRE(resizable.try_allocate(1).error() == allocator::alloc_error::capacity_exceeded);
+    }
+}
+
+// The check policy picks the validation of deallocate at compile time
+TEST_CASE("stack_allocator - Deallocation check policies", "[stack_allocator][policy]") {
+    using allocator::check_policy;
+    allocator::stack_allocator stack(1024);
+
+    void* first = stack.allocate(64);
+    void* second = stack.allocate(64);
+
+    // paranoid enforces the LIFO order, checked only that the pointer is below the top
+    REQUIRE_THROWS_AS(stack.deallocate<check_policy::paranoid>(first), std::invalid_argument);
+    REQUIRE_THROWS_AS(stack.deallocate<check_policy::checked>(nullptr), std::invalid_argument);
+    REQUIRE_THROWS_AS(stack.deallocate<check_policy::checked>(static_cast<std::byte*>(second) + 64),
+                      std::invalid_argument);
+    stack.deallocate<check_policy::paranoid>(second);
+    stack.deallocate<check_policy::paranoid>(first);
+    REQUIRE(stack.getAllocatedSize() == 0);
+
+    SECTION("Unchecked frees of a trusted loop") {
+        std::vector<void*> chunks;
+        for (int i = 0; i < 8; ++i) {
+            chunks.push_back(stack.allocate(100));
+        }
+        for (auto it = chunks.rbegin(); it != chunks.rend(); ++it) {
+            stack.deallocate<check_policy::unchecked>(*it);
+        }
+        REQUIRE(stack.getAllocatedSize() == 0);
+    }
+
+    SECTION("Rewinding to a mark keeps the LIFO order of the older allocations") {
+        void* kept = stack.allocate(32);
+        auto mark = stack.mark();
+        [[maybe_unused]] void* dropped = stack.allocate(32);
+        stack.reset_to_mark(mark);
+        stack.deallocate<check_policy::paranoid>(kept);
+        REQUIRE(stack.getAllocatedSize() == 0);
+    }
+}
+
+// Moving hands the buffers and marks over, the source is left empty
+TEST_CASE("stack_allocator - Move and swap", "[stack_allocator][move]") {
+    allocator::stack_allocator source(1024);
+    void* first = source.allocate(64);
+    auto mark = source.mark();
+    [[maybe_unused]] void* second = source.allocate(64);
+
+    allocator::stack_allocator moved = std::move(source);
+    REQUIRE(moved.getAllocatedSize() == 128);
+    REQUIRE(source.getAllocatedSize() == 0);
+    REQUIRE(source.try_allocate(8).error() == allocator::alloc_error::no_memory);
+
+    moved.reset_to_mark(mark);
+    moved.deallocate(first);
+    REQUIRE(moved.getAllocatedSize() == 0);
+
+    allocator::stack_allocator frame(256);
+    void* scratch = frame.allocate(32);
+    swap(moved, frame); // per-request arenas trade places
+    REQUIRE(moved.getAllocatedSize() == 32);
+    moved.deallocate(scratch);
+
+    source.reset();
+    REQUIRE(source.allocate(16) != nullptr);
+}
@@ -0,0 +1,155 @@
+#include "allocator/tlsf_allocator.hpp"
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Allocate and free variable sizes
+TEST_CASE("tlsf Allocator - Allocate and deallocate blocks", "[tlsf_allocator][basic]") {
+    allocator::tlsf_allocator tlsf(1024 * 1024); // 1mb buffer
+    void* ptr1 = tlsf.allocate(100);
+    void* ptr2 = tlsf.allocate(3000);
+    void* ptr3 = tlsf.allocate(1);
+    REQUIRE(ptr1 != nullptr);
+    REQUIRE(ptr2 != nullptr);
+    REQUIRE(ptr3 != nullptr);
+    REQUIRE(reinterpret_cast<uintptr_t>(ptr1) % 8 == 0);
+    REQUIRE(reinterpret_cast<uintptr_t>(ptr2) % 8 == 0);
+
+    // sizes are rounded to 8 bytes with a 24 byte minimum, no power-of-two rounding
+    REQUIRE(tlsf.getObjectSize() == 24);
+    REQUIRE(tlsf.getAllocatedSize() == 104 + 3000 + 24);
+
+    tlsf.deallocate(ptr1);
+    tlsf.deallocate(ptr2);
+    tlsf.deallocate(ptr3);
+    REQUIRE(tlsf.getAllocatedSize() == 0);
+}
+
+// Freed neighbours are merged through the boundary tags
+TEST_CASE("tlsf Allocator - Coalescing", "[tlsf_allocator][coalesce]") {
+    allocator::tlsf_allocator tlsf(64 * 1024); // 64kb buffer
+
+    void* ptr1 = tlsf.allocate(16 * 1024);
+    void* ptr2 = tlsf.allocate(16 * 1024);
+    void* ptr3 = tlsf.allocate(16 * 1024);
+    REQUIRE(ptr3 != nullptr);
+
+    // free the middle one last, it merges with the previous and the next block at once
+    tlsf.deallocate(ptr1);
+    tlsf.deallocate(ptr3);
+    tlsf.deallocate(ptr2);
+
+    // one block spans the buffer again. A request is rounded up to the next list (good fit), so
+    // the largest request guaranteed to fit is one list step below the block size
+    void* whole = tlsf.allocate(60 * 1024);
+    REQUIRE(whole == ptr1);
+    tlsf.deallocate(whole);
+}
+
+// Over-aligned requests
+TEST_CASE("tlsf Allocator - Alignment", "[tlsf_allocator][alignment]") {
+    allocator::tlsf_allocator tlsf(1024 * 1024);
+
+    std::vector<void*> ptrs;
+    for (size_t alignment : {16, 32, 64, 256, 4096}) {
+        void* ptr = tlsf.allocate(100, alignment);
+        REQUIRE(ptr != nullptr);
+        REQUIRE(reinterpret_cast<uintptr_t>(ptr) % alignment == 0);
+        ptrs.push_back(ptr);
+    }
+
+    for (void* ptr : ptrs) {
+        tlsf.deallocate(ptr);
+    }
+    REQUIRE(tlsf.getAllocatedSize() == 0);
+
+    // the leading gaps were given back and merged
+    REQUIRE(tlsf.allocate(960 * 1024) != nullptr);
+}
+
+// Random workload, payloads must never overlap
+TEST_CASE("tlsf Allocator - Random workload", "[tlsf_allocator][stress]") {
+    allocator::tlsf_allocator tlsf(16 * 1024 * 1024);
+    std::mt19937 rng{1234};
+    std::uniform_int_distribution<size_t> sizeDist(1, 8192);
+
+    struct live {
+        unsigned char* ptr;
+        size_t size;
+        unsigned char pattern;
+    };
+    std::vector<live> blocks;
+
+    for (int step = 0; step < 5000; ++step) {
+        if (blocks.empty() || rng() % 3 != 0) {
+            size_t size = sizeDist(rng);
+            auto* ptr = static_cast<unsigned char*>(tlsf.allocate(size));
+            REQUIRE(ptr != nullptr);
+            auto pattern = static_cast<unsigned char>(step);
+            std::memset(ptr, pattern, size);
+            blocks.push_back({ptr, size, pattern});
+        } else {
+            size_t index = rng() % blocks.size();
+            live block = blocks[index];
+            REQUIRE(std::all_of(block.ptr, block.ptr + block.size,
+                                [&](unsigned char c) { return c == block.pattern; }));
+            tlsf.deallocate(block.ptr);
+            blocks[index] = blocks.back();
+            blocks.pop_back();
+        }
+    }
+
+    for (auto& block : blocks) {
+        tlsf.deallocate(block.ptr);
+    }
+    REQUIRE(tlsf.getAllocatedSize() == 0);
+    REQUIRE(tlsf.allocate(15 * 1024 * 1024) != nullptr);
+}
+
+// Exhaustion, reset and invalid frees
+TEST_CASE("tlsf Allocator - Edge cases", "[tlsf_allocator][edge]") {
+    REQUIRE_THROWS_AS(allocator::tlsf_allocator(512), std::invalid_argument);
+    REQUIRE_THROWS_AS(allocator::tlsf_allocator(256ull * 1024 * 1024), std::invalid_argument);
+
+    allocator::tlsf_allocator tlsf(64 * 1024);
+
+    SECTION("Out of memory") {
+        void* ptr = tlsf.allocate(60 * 1024);
+        REQUIRE(ptr != nullptr);
+#if ALLOCATOR_DEBUG
+        REQUIRE_THROWS(tlsf.allocate(8 * 1024));
+#else
+        REQUIRE(tlsf.allocate(8 * 1024) == nullptr);
+#endif
+        tlsf.reset();
+        REQUIRE(tlsf.getAllocatedSize() == 0);
+        REQUIRE(tlsf.allocate(60 * 1024) == ptr);
+    }
+
+    SECTION("try_allocate reports the error instead of throwing") {
+        auto ptr = tlsf.try_allocate(60 * 1024);
+        REQUIRE(ptr.has_value());
+        REQUIRE(tlsf.try_allocate(8 * 1024).error() == allocator::alloc_error::out_of_memory);
+        REQUIRE(tlsf.try_allocate(64, 24).error() == allocator::alloc_error::invalid_alignment);
+        tlsf.deallocate(*ptr);
+    }
+
+    SECTION("Invalid deallocation") {
+        void* ptr = tlsf.allocate(128);
+        int outside = 0;
+        REQUIRE_THROWS_AS(tlsf.deallocate(nullptr), std::invalid_argument);
+        REQUIRE_THROWS_AS(tlsf.deallocate(&outside), std::invalid_argument);
+
+        tlsf.deallocate(ptr);
+        REQUIRE_THROWS_AS(tlsf.deallocate(ptr), std::invalid_argument); // double free
+    }
+
+    SECTION("Release memory") {
+        tlsf.releaseMemory();
+        REQUIRE(tlsf.getAllocatedSize() == 0);
+        tlsf.reset(); // allocates a new buffer
+        REQUIRE(tlsf.allocate(1024) != nullptr);
+    }
+}
@@ -0,0 +1,90 @@
+#include "allocator/tree_buddy_allocator.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+// Allocate a block
+TEST_CASE("tree buddy Allocator - Allocate and deallocate blocks",
+          "[tree_buddy_allocator][basic]") {
+    allocator::tree_buddy_allocator treeAllocator(1024 * 1024); // 1mb buffer
+    void* ptr1 = treeAllocator.allocate(3000);                  // 4kb block
+    void* ptr2 = treeAllocator.allocate(1024);                  // 1kb block
+    REQUIRE(ptr1 != nullptr);
+    REQUIRE(ptr2 != nullptr);
+    REQUIRE(treeAllocator.getAllocatedSize() == 5 * 1024);
+
+    treeAllocator.deallocate(ptr1);
+    treeAllocator.deallocate(ptr2);
+    REQUIRE(treeAllocator.getAllocatedSize() == 0);
+
+    // everything merged back, the whole buffer is available again
+    REQUIRE(treeAllocator.allocate(1024 * 1024) == ptr1);
+}
+
+// Abstract ranges, no backing memory
+TEST_CASE("tree buddy Allocator - Abstract ranges", "[tree_buddy_allocator][range]") {
+    // 96 units of 4096, e.g. pages of a file
+    allocator::tree_buddy_allocator ranges(96 * 4096, 4096, false);
+
+    size_t a = ranges.allocate_range(64 * 4096);
+    size_t b = ranges.allocate_range(32 * 4096);
+    REQUIRE(a == 0);
+    REQUIRE(b == 64 * 4096);
+
+    // capacity is exact, the padding up to 128 units is never handed out
+    REQUIRE(ranges.allocate_range(4096) == allocator::tree_buddy_allocator::npos);
+
+    ranges.deallocate_range(b);
+    size_t c = ranges.allocate_range(4096);
+    size_t d = ranges.allocate_range(4096);
+    REQUIRE(c == 64 * 4096);
+    REQUIRE(d == 65 * 4096);
+
+    // pointer interface is not available without backing memory
+    REQUIRE_THROWS(ranges.allocate(4096));
+}
+
+// Invalid deallocation(e.g., double free, invalid pointer, null pointer, after release)
+TEST_CASE("tree buddy Allocator - Invalid deallocation", "[tree_buddy_allocator][edge]") {
+    allocator::tree_buddy_allocator treeAllocator(64 * 1024);
+    void* ptr1 = treeAllocator.allocate(4096);
+    void* ptr2 = treeAllocator.allocate(4096);
+
+    // interior pointer
+    REQUIRE_THROWS_AS(treeAllocator.deallocate(static_cast<std::byte*>(ptr2) + 1024),
+                      std::invalid_argument);
+
+    treeAllocator.deallocate(ptr1);
+    REQUIRE_THROWS_AS(treeAllocator.deallocate(ptr1), std::invalid_argument); // double free
+
+    int invalidPtr;
+    REQUIRE_THROWS_AS(treeAllocator.deallocate(&invalidPtr), std::invalid_argument);
+    REQUIRE_THROWS_AS(treeAllocator.deallocate(nullptr), std::invalid_argument);
+
+    treeAllocator.releaseMemory();
+    REQUIRE_THROWS_AS(treeAllocator.deallocate(ptr2), std::invalid_argument);
+}
+
+// Exhaust the tree with minimum blocks and free them in a scattered order
+TEST_CASE("tree buddy Allocator - Fill and coalesce", "[tree_buddy_allocator][basic]") {
+    allocator::tree_buddy_allocator treeAllocator(64 * 1024); // 64 blocks of 1kb
+
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 64; ++i) {
+        ptrs.push_back(treeAllocator.allocate(1024));
+    }
+    REQUIRE_THROWS(treeAllocator.allocate(1024)); // full
+
+    for (int i = 0; i < 64; i += 2) {
+        treeAllocator.deallocate(ptrs[i]);
+    }
+    REQUIRE_THROWS(treeAllocator.allocate(2048)); // only isolated 1kb holes
+
+    for (int i = 1; i < 64; i += 2) {
+        treeAllocator.deallocate(ptrs[i]);
+    }
+    REQUIRE(treeAllocator.allocate(64 * 1024) == ptrs[0]);
+
+    treeAllocator.reset();
+    REQUIRE(treeAllocator.getAllocatedSize() == 0);
+    REQUIRE(treeAllocator.allocate(32 * 1024) == ptrs[0]);
+}